@@ -1,24 +1,191 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h> // offsetof
+#include <stdint.h> // uint64_t, uint32_t
+#include <limits.h> // INT_MAX
+#include <pthread.h>
+#include <unistd.h> // sysconf
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <fcntl.h> // open
+#include <time.h> // clock_gettime
+
+#include "name_scan.h"
+#include "name_out.h"
+#include "name_query.h"
+#include "adt_heap.h"
+
+#if defined(__AVX2__) || defined(__SSSE3__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
-#define MAX_YEAR_DURATION	10	// 기간
 #define LINEAR_SEARCH 0
 #define BINARY_SEARCH 1
+#define HASH_SEARCH 2
+#define STATISTICS 3
+#define PARALLEL 4
+#define SNAPSHOT 5
+#define APPEND 6
+#define QUERY 7
+#define TOP_K 8
+#define RANGE 9
+#define COMPRESSED 10
+#define FINGERPRINT 11
+
+#define SNAPSHOT_MAGIC		"NAMESNAP"	// 스냅샷 파일 식별자 (8 bytes)
+#define SNAPSHOT_VERSION	2			// 스냅샷 파일 형식 버전 (2: 이름 뒤가 0으로 채워짐)
+
+#define MAX_THREADS	64	// 병렬 읽기 모드의 최대 스레드 수
+#define RADIX_CUTOFF	32	// 기수 정렬에서 삽입 정렬로 전환하는 버킷 크기
+#define KEY_DIGITS		20	// 압축 키의 자릿수 (이름 19 bytes + 성별)
+#define LOOKUP_BATCH	16	// 일괄 조회에서 함께 진행하는 탐색의 수
+#define ZBLOCK		32	// 압축 행에서 시작 위치를 저장하는 간격 (행의 수)
+#define MIN_CHUNK	(1 << 20)	// 스레드 하나가 맡는 최소 입력 크기 (바이트)
+#define MIN_PRINT_ROWS	(1 << 15)	// 출력 스레드 하나가 맡는 최소 이름의 수
+#define PARALLEL_PRINT	1 // 1: 여러 스레드가 구간별로 출력을 만들어 순서대로 내보냄, 0: 한 스레드로 출력 (used in print_names function)
 
 // 구조체 선언
+// 연도별 빈도는 구조체 뒤에 연도의 수(names->num_year)만큼 이어서 저장됨
+// 배열 원소의 크기가 names->rec_size이므로 배열은 NAME_AT으로 접근해야 함
 typedef struct {
 	char	name[20];		// 이름
 	char	sex;			// 성별 'M' or 'F'
-	int		freq[MAX_YEAR_DURATION]; // 연도별 빈도
+	int		freq[];			// 연도별 빈도 (num_year개)
 } tName;
 
 typedef struct {
 	int		len;		// 배열에 저장된 이름의 수
 	int		capacity;	// 배열의 용량 (배열에 저장 가능한 이름의 수)
 	tName	*data;		// 이름 배열의 포인터
+	size_t	map_size;	// 스냅샷을 mmap으로 연 경우 매핑 크기 (0이면 malloc으로 할당된 배열)
+	int		start_year;	// 시작 연도
+	int		num_year;	// 연도의 수 (0이면 아직 읽은 연도가 없음)
+	int		rec_size;	// 이름 구조체 하나의 크기 (REC_SIZE(num_year))
 } tNames;
 
+// 연도의 수가 num_year인 이름 구조체의 크기
+#define REC_SIZE(num_year)	(offsetof(tName, freq) + (size_t)(num_year) * sizeof(int))
+
+// 이름 구조체 배열의 i번째 이름
+#define NAME_AT(names, i)	((tName *)((char *)(names)->data + (size_t)(i) * (names)->rec_size))
+
+// 스냅샷 파일 헤더 (64 bytes)
+// 헤더 다음에 정렬된 이름 구조체 배열(count개)이 그대로 저장됨
+typedef struct {
+	char	magic[8];		// SNAPSHOT_MAGIC
+	int		version;		// SNAPSHOT_VERSION
+	int		count;			// 이름의 수
+	int		start_year;		// 시작 연도
+	int		num_year;		// 연도의 수 (저장된 연도 범위: start_year ~ start_year + num_year - 1)
+	int		rec_size;		// 이름 구조체의 크기
+	int		reserved[9];
+} tSnapHeader;
+
+// 정렬, 탐색을 위한 압축 키 (24 bytes)
+// 이름(최대 19자)과 성별을 big-endian 정수로 묶어, 정수 비교만으로 이름(1순위), 성별(2순위) 순서를 결정
+// 이름이 name[20]에 모두 들어가므로 키가 같으면 이름과 성별이 모두 같음 (전체 이름 비교가 필요 없음)
+typedef struct {
+	uint64_t	hi;		// 이름의 0~7번째 바이트
+	uint64_t	lo;		// 이름의 8~15번째 바이트
+	uint32_t	tail;	// 이름의 16~18번째 바이트 + 성별
+	uint32_t	idx;	// names->data의 인덱스
+} tKey;
+
+// 조회 전용 인덱스 (Eytzinger layout)
+// 정렬된 압축 키를 BFS 순서(key[1]이 루트, key[k]의 자식은 key[2k], key[2k+1])로 배치
+// 탐색 경로의 윗부분이 캐시에 모이고, 다음 단계의 노드를 미리 prefetch할 수 있음
+typedef struct {
+	int		len;	// 키의 수
+	tKey	*key;	// Eytzinger 순서의 키 배열 (len + 1개, key[0]은 사용하지 않음)
+} tFrozen;
+
+// 조회 모드의 조회 대상
+typedef struct {
+	tNames	*names;		// 정렬된 이름 구조체 배열
+	tKey	*keys;		// 배치를 정렬한 압축 키 (QUERY_BATCH개, idx: 배치 안의 위치)
+	tFrozen	*frozen;	// 조회 전용 인덱스 (Eytzinger layout)
+} tQueryTable;
+
+// 해시 인덱스 (open addressing, linear probing)
+// 슬롯에는 names->data의 인덱스를 저장하므로 realloc으로 배열이 이동해도 유효함
+typedef struct {
+	int		size;		// 슬롯 수 (2의 거듭제곱)
+	int		count;		// 사용 중인 슬롯 수
+	int		*slot;		// names->data의 인덱스 (-1이면 빈 슬롯)
+} tHash;
+
+// 병렬 읽기 모드에서 작업 스레드 하나가 맡는 입력 구간과 결과
+typedef struct {
+	SCANNER	part;		// 입력 구간
+	tNames	*run;		// 구간에서 읽은 이름 (정렬된 run, 연도 범위는 구간마다 다름)
+} tWorker;
+
+// 병렬 출력에서 출력 스레드 하나가 맡는 이름 구간과 출력 결과
+typedef struct {
+	tNames	*names;		// 출력할 이름 구조체 배열
+	int		from, to;	// 이름 구간 [from, to)
+	WRITER	*out;		// 구간의 출력 (메모리 버퍼)
+} tPrinter;
+
+// 열 지향(columnar) 이름 구조체
+// 연도별 빈도를 연도마다 연속된 int 배열로 저장하여, 연도별 집계 시 이름 데이터를 읽지 않음
+typedef struct {
+	int		len;			// 저장된 이름의 수
+	int		start_year;		// 시작 연도
+	int		num_year;		// 연도의 수
+	char	(*name)[20];	// 이름 열
+	char	*sex;			// 성별 열
+	int		**freq;			// 연도별 빈도 열 (num_year개)
+} tNamesCol;
+
+// 연도별 집계 결과
+typedef struct {
+	long long	total;	// 전체 빈도 합
+	long long	male;	// 남자 빈도 합
+	long long	female;	// 여자 빈도 합
+	int			min;	// 최소 빈도 (해당 연도에 등장한 이름 중)
+	int			max;	// 최대 빈도
+} tYearStat;
+
+// 연도별 상위 K개 이름 탐색에서 힙에 저장하는 원소
+typedef struct {
+	int		freq;	// 빈도
+	int		idx;	// 열 지향 구조체의 행 인덱스 (정렬 순서)
+} tTop;
+
+// 연도별 누적 빈도 (정렬 순서)
+// sum[y][i] : 정렬된 이름 구조체 배열의 0 ~ i-1번째 이름의 y번째 연도 빈도 합
+// 정렬 순서에서 연속된 구간 [lo, hi)의 빈도 합은 sum[y][hi] - sum[y][lo]
+typedef struct {
+	int			len;		// 이름의 수
+	int			num_year;	// 연도의 수
+	long long	**sum;		// 연도별 누적 빈도 (num_year개, 각각 len + 1개)
+} tPrefixSum;
+
+// 빈도 행을 압축한 이름 구조체
+// 행마다 [등장 연도 비트맵 (연도당 1 bit)][제어 바이트][값 바이트들]을 이어서 저장 (stream-vbyte)
+// 등장한 연도의 빈도만 저장하고, 제어 바이트의 2 bit마다 값 하나의 바이트 수(1~4)를 기록
+// 행의 길이가 가변이므로 ZBLOCK행마다 시작 위치를 저장하여 임의 접근
+typedef struct {
+	int		len;		// 저장된 이름의 수
+	int		start_year;	// 시작 연도
+	int		num_year;	// 연도의 수
+	char	(*name)[20];// 이름 열
+	char	*sex;		// 성별 열
+	size_t	*block;		// ZBLOCK행마다 data에서의 시작 위치
+	uint8_t	*data;		// 압축된 빈도 행
+	size_t	size;		// data의 크기 (bytes)
+	uint32_t *vals;		// 행 하나를 풀 때 사용하는 값 버퍼 (num_year를 4의 배수로 올린 크기)
+} tNamesZ;
+
+// 압축 조회 모드의 조회 대상
+typedef struct {
+	tNamesZ	*z;			// 압축 구조체 (이름, 성별 열은 정렬되어 있음)
+	tKey	*keys;		// 배치를 정렬한 압축 키 (QUERY_BATCH개, idx: 배치 안의 위치)
+	int		*freq;		// 행 하나를 풀어 출력할 때 사용하는 빈도 버퍼 (num_year개)
+} tQueryTableZ;
+
 ////////////////////////////////////////////////////////////////////////////////
 // 함수 원형 선언(declaration)
 
@@ -27,38 +194,245 @@ typedef struct {
 // 새로 등장한 이름은 구조체에 추가
 // 주의사항: 동일 이름이 남/여 각각 사용될 수 있으므로, 이름과 성별을 구별해야 함
 // names->capacity는 1000으로부터 시작하여 1000씩 증가 (1000, 2000, 3000, ...)
-// start_year : 시작 연도 (2009)
+// 연도 범위는 입력에서 결정 (year_index); 읽은 후 실제로 등장한 연도 범위로 맞춤 (fit_years)
+// return	1 successful
+//			0 입력을 끝까지 읽지 못한 경우 (메모리 부족, 읽기 오류; 아래의 load_names_* 모두 같음)
 // 선형탐색(linear search) 버전
-void load_names_lsearch( FILE *fp, int start_year, tNames *names);
+int load_names_lsearch( FILE *fp, tNames *names);
 
 // 이진탐색(binary search) 버전
 // bsearch 함수 이용; qsort 함수를 이용하여 이름 구조체의 정렬을 유지해야 함
-void load_names_bsearch( FILE *fp, int start_year, tNames *names);
+int load_names_bsearch( FILE *fp, tNames *names);
+
+// 해시 인덱스 버전
+// (이름, 성별)을 키로 하는 해시 인덱스를 이용하여 행마다 O(1)에 탐색
+// 이름은 등장 순서대로 배열에 추가되므로, 출력 전 qsort 한 번으로 정렬해야 함
+int load_names_hash( FILE *fp, tNames *names);
+
+// 지문(fingerprint) 선형탐색 버전
+// 이름 구조체 배열과 나란한 1 byte 해시 지문 배열을 SIMD로 한 번에 32/64개씩 비교하고,
+// 지문이 같은 이름만 compare_name으로 확인 (정렬하지 않는 선형탐색의 기준선)
+int load_names_fingerprint( FILE *fp, tNames *names);
+
+// 병렬 읽기 버전
+// 입력을 줄 단위의 구간으로 나누어 구간마다 작업 스레드가 해시 인덱스로 읽고 정렬된 run을 만듦
+// run들을 k-way merge하면서 같은 이름(성별)의 연도별 빈도를 합산
+// 결과는 이미 정렬되어 있으므로 출력 전 정렬이 필요 없음
+int load_names_parallel( FILE *fp, tNames *names);
+
+// 연도 year의 인덱스 (year - names->start_year)
+// year가 연도 범위를 벗어나면 범위를 넓힘 (resize_years)
+// 넓힐 때는 다시 넓히는 횟수를 줄이기 위해 여유를 두므로, 읽기가 끝나면 fit_years로 맞춰야 함
+// 주의사항: 범위를 넓히면 배열이 다시 할당되므로 이전에 얻은 이름 구조체의 포인터는 무효
+int year_index( tNames *names, int year);
+
+// 연도 범위를 start_year ~ start_year + num_year - 1로 바꾸고 모든 행을 새 크기로 다시 배치
+// 범위 밖의 연도 빈도는 버려지며, 새로 생긴 연도의 빈도는 0
+// 스냅샷에서 연 (읽기 전용) 이름 구조체는 메모리로 복사됨
+void resize_years( tNames *names, int start_year, int num_year);
+
+// 연도 범위를 빈도가 0이 아닌 연도가 있는 범위로 줄임
+void fit_years( tNames *names);
+
+// 해시 인덱스를 생성 (size는 2의 거듭제곱)
+// return : 해시 인덱스 포인터
+tHash *create_hash( int size);
+
+// 해시 인덱스에 할당된 메모리를 해제
+void destroy_hash( tHash *hash);
+
+// 이름 구조체 배열로부터 열 지향 구조체를 생성
+// return	열 지향 구조체 포인터
+//			NULL if overflow
+tNamesCol *create_names_col( tNames *names);
+
+// 열 지향 구조체에 할당된 메모리를 해제
+void destroy_names_col( tNamesCol *cols);
+
+// 빈도 열의 합 (SIMD)
+long long col_sum( const int *col, int n);
+
+// 성별이 sex인 행만의 빈도 열의 합 (SIMD)
+long long col_sum_sex( const int *col, const char *sex, int n, char s);
+
+// 빈도 열의 최소값, 최대값 (SIMD)
+// 빈도가 0인(해당 연도에 등장하지 않은) 이름은 최소값 계산에서 제외
+// 등장한 이름이 없으면 0
+int col_min( const int *col, int n);
+int col_max( const int *col, int n);
+
+// 연도(인덱스 year)의 집계 결과를 계산
+void year_stat( tNamesCol *cols, int year, tYearStat *stat);
+
+// 연도별 집계 결과를 화면에 출력
+void print_stats( tNamesCol *cols);
+
+// 연도별, 성별 빈도 상위 k개의 이름을 화면에 출력
+// 열을 한 번만 순회하면서 (연도, 성별)마다 크기 k의 최소 힙(adt_heap)을 유지 : O(n log k)
+// 빈도가 같으면 정렬 순서(이름순)가 앞선 이름이 우선; 빈도가 0인 이름은 제외
+// cols는 정렬된 이름 구조체로부터 생성되어야 함
+// k는 이름의 수로 제한됨 (힙에 이름의 수보다 많은 원소가 들어갈 수 없음)
+// return	1 successful
+//			0 if overflow
+int top_names( tNamesCol *cols, int k);
+
+// 정렬된 이름 구조체 배열로부터 연도별 누적 빈도를 생성
+// return	누적 빈도 구조체 포인터
+//			NULL if overflow
+tPrefixSum *create_prefix_sum( tNames *names);
+
+// 누적 빈도 구조체에 할당된 메모리를 해제
+void destroy_prefix_sum( tPrefixSum *ps);
+
+// 정렬된 이름 구조체 배열에서 이름이 key 이상인 첫번째 위치 (lower bound, 성별 무시)
+int lower_name( tNames *names, const char *key);
+
+// 정렬된 이름 구조체 배열에서 이름이 prefix로 시작하는 이름들의 구간 [*lo, *hi)
+// 이름순으로 정렬되어 있으므로 구간은 연속됨 : O(log n)
+void prefix_range( tNames *names, const char *prefix, int *lo, int *hi);
+
+// 정렬 순서 구간 [lo, hi)에 있는 이름들의 연도(인덱스 year) 빈도 합 : O(1)
+long long range_sum( tPrefixSum *ps, int lo, int hi, int year);
+
+// 이름 구조체 배열로부터 빈도 행을 압축한 구조체를 생성
+// return : 압축 구조체 포인터
+tNamesZ *create_names_z( tNames *names);
+
+// 압축 구조체에 할당된 메모리를 해제
+void destroy_names_z( tNamesZ *z);
+
+// i번째 이름의 연도별 빈도를 freq에 풀어서 저장 (임의 접근)
+void z_get( tNamesZ *z, int i, int *freq);
+
+// 모든 행을 순서대로 풀면서 연도별 빈도 합을 계산 (SIMD 디코딩)
+void z_year_sums( tNamesZ *z, long long *sum);
+
+// 압축 구조체를 화면에 출력 (print_names와 같은 형식)
+void print_names_z( tNamesZ *z);
+
+// 압축 조회 모드
+// query_names와 같은 형식의 조회에 압축 구조체만으로 답함 (gallop)
+// 찾은 이름의 빈도는 z_get으로 해당 행만 풀어서 출력
+void query_names_z( tNamesZ *z, FILE *in);
+
+// 이름과 성별로 압축 키를 생성 (idx: names->data의 인덱스)
+void make_key( const char *name, char sex, uint32_t idx, tKey *key);
+
+// 압축 키 비교 함수 (qsort, bsearch)
+// 정렬 기준 : 이름(1순위), 성별(2순위)
+int compare_key( const void *k1, const void *k2);
+
+// 압축 키 배열을 MSD 기수 정렬 (이름의 각 바이트, 마지막 자리는 성별)
+// 크기가 RADIX_CUTOFF 이하인 버킷은 삽입 정렬
+// 결과는 compare_key(compare)를 이용한 qsort와 같은 순서
+void radix_sort_keys( tKey *keys, int n);
+
+// 이름 구조체 배열을 정렬 (이름순 (이름이 같은 경우 성별순))
+// 레코드 대신 압축 키와 인덱스를 기수 정렬한 후, 레코드는 마지막에 한 번만 재배치
+void sort_names( tNames *names);
 
-// 구조체 배열을 화면에 출력
-void print_names( tNames *names, int num_year);
+// 정렬된 이름 구조체 배열로부터 조회 전용 인덱스를 생성 (freeze)
+// 이후 이름 구조체 배열이 바뀌면 다시 생성해야 함
+// return : 조회 전용 인덱스 포인터
+tFrozen *freeze_names( tNames *names);
+
+// 조회 전용 인덱스에 할당된 메모리를 해제
+void destroy_frozen( tFrozen *frozen);
+
+// 이름과 성별로 조회 (분기 없는 탐색 + prefetch)
+// return	이름 구조체 배열의 인덱스
+//			-1 not found
+int lookup_name( tFrozen *frozen, const char *name, char sex);
+
+// 여러 이름을 한 번에 조회
+// LOOKUP_BATCH개의 탐색을 한 단계씩 함께 진행하여 메모리 접근 지연을 겹침
+// query : 조회할 이름과 성별 배열 (n개)
+// out : 이름 구조체 배열의 인덱스를 전달받음 (없으면 -1)
+void lookup_names( tFrozen *frozen, const tQuery *query, int n, int *out);
+
+// 이름 구조체를 초기화 (연도 범위는 비어 있음)
+tNames *create_names(void);
+
+// 이름 구조체에 할당된 메모리를 해제
+void destroy_names(tNames *pnames);
+
+// 정렬된 이름 구조체 배열을 스냅샷 파일로 저장
+// 임시 파일에 쓴 후 이름을 바꾸므로, 기존 파일은 항상 온전한 상태로 남음
+// return	1 successful
+//			0 if failed
+int save_names( tNames *names, const char *path);
+
+// 스냅샷 파일을 읽기 전용으로 mmap하여 이름 구조체를 생성 (파싱, 복사 없음)
+// 반환된 이름 구조체의 배열은 수정할 수 없으며, destroy_names로 해제
+// 연도 범위는 스냅샷 헤더의 start_year, num_year
+// return	이름 구조체 포인터
+//			NULL if failed (파일이 없거나 형식이 맞지 않는 경우)
+tNames *open_names( const char *path);
+
+// 정렬된 이름 구조체에 새 연도(들)의 입력 파일을 반영
+// 이미 존재하는 이름은 bsearch로 찾아 해당 연도의 빈도만 갱신하고,
+// 새로 등장한 이름은 모아서 정렬한 후 기존 배열과 한 번에 병합
+// 전체 입력 파일을 다시 읽지 않으므로 새 파일의 크기에 비례하는 시간이 걸림
+// 스냅샷에서 연 (읽기 전용) 이름 구조체는 먼저 메모리로 복사됨
+// 새 연도가 연도 범위를 벗어나면 범위를 넓힘
+// return	1 successful
+//			0 새 입력 파일을 끝까지 읽지 못한 경우 (메모리 부족, 읽기 오류)
+int append_names( tNames *names, FILE *fp);
+
+// 조회 모드
+// in에서 "이름 성별" 형식의 조회를 QUERY_BATCH개씩 읽어, 배치마다 세 가지 방법으로 답하고 시간을 비교
+//	gallop : 배치를 정렬한 후 정렬된 이름 구조체 배열과 한 번의 병합 순회(galloping)
+//	eytzinger : 처음에 한 번 생성한 조회 전용 인덱스에서 하나씩 탐색 (lookup_name)
+//	eytzinger batch : 조회 전용 인덱스에서 LOOKUP_BATCH개씩 함께 탐색 (lookup_names)
+// 조회 결과(연도별 빈도)는 입력 순서대로 출력하고, 없는 이름은 "not found"를 출력
+// 배치별 처리량과 지연 시간, 전체 지연 시간 분포(percentile)는 stderr에 출력
+void query_names( tNames *names, FILE *in);
+
+// 구조체 배열을 화면에 출력 (연도 범위의 모든 연도)
+void print_names( tNames *names);
 
 // qsort, bsearch를 위한 비교 함수
 // 정렬 기준 : 이름(1순위), 성별(2순위)
 int compare( const void *n1, const void *n2);
 
+// 0으로 채워진 20 bytes 이름 두 개를 비교 (strcmp와 같은 순서)
+// 앞 16 bytes는 SSE2 한 번, 나머지 4 bytes는 byte-swap한 정수 하나로 비교
+// return	음수, 0, 양수 (strcmp와 같은 부호)
+int compare_name( const char *a, const char *b);
+
+// 이름을 name[20]에 복사하고 남은 뒤를 0으로 채움 (19자보다 긴 이름은 잘림)
+void copy_name( char *dst, const char *src);
+
 ////////////////////////////////////////////////////////////////////////////////
 // 함수 정의 (definition)
 
-void load_names_lsearch( FILE *fp, int start_year, tNames *names){
+int load_names_lsearch( FILE *fp, tNames *names){
 
 	char tmp_name[20], tmp_sex;
 	int tmp_year, tmp_freq;
+	int first_year = 0; // 입력의 첫 연도 (첫 연도에는 중복된 이름이 없으므로 탐색 생략)
+	int ok;
+	SCANNER *sc = scan_Open( fp);
+	tRecord rec;
+
+	if( sc == NULL) return 0;
 
-	while(!feof( fp)){ // feof 함수: 파일의 끝에 도달 여부 확인
+	while( scan_Next( sc, &rec)){ // 입력 파일의 다음 한 줄을 불러옴
 		// 다음 한 줄을 읽기 위해 사용된 변수들 초기화
 		int i = 0;
+		int y;
 
-		fscanf( fp, "%d %s %c %d\n", &tmp_year, tmp_name, &tmp_sex, &tmp_freq); // fscanf 함수: 파일의 데이터를 불러옴
+		tmp_year = rec.year;
+		scan_Copy( &rec, tmp_name, sizeof(tmp_name));
+		tmp_sex = rec.sex;
+		tmp_freq = rec.freq;
+
+		if( names->num_year == 0) first_year = tmp_year;
+		y = year_index( names, tmp_year);
 
 		for( i = 0; i < names->len; i++){
-			if( (tmp_year - start_year) != 0 && !strcmp(tmp_name, names->data[i].name) && tmp_sex == names->data[i].sex){
-				names->data[i].freq[tmp_year - start_year] = tmp_freq;
+			if( tmp_year != first_year && tmp_sex == NAME_AT(names, i)->sex && compare_name(tmp_name, NAME_AT(names, i)->name) == 0){
+				NAME_AT(names, i)->freq[y] = tmp_freq;
 				break;
 			}
 		}
@@ -67,197 +441,2141 @@ void load_names_lsearch( FILE *fp, int start_year, tNames *names){
 			if( names->len == names->capacity){
 				// capacity 가 부족하면 +1000
 				names->capacity += 1000;
-				names->data = (tName *)realloc(names->data, names->capacity * sizeof(tName));
+				names->data = (tName *)realloc(names->data, names->capacity * names->rec_size);
 			}
 
-			else{ // 새로운 정보 추가
-
-				for (int j = 0; j < 10; j++){
-                	names->data[names->len].freq[j] = 0;
-           		}
-
-				strcpy(names->data[names->len].name, tmp_name);
-				names->data[names->len].sex = tmp_sex;
-				names->data[names->len].freq[tmp_year - start_year] = tmp_freq;
-				names->len ++;
+			// 새로운 정보 추가
+			for (int j = 0; j < names->num_year; j++){
+				NAME_AT(names, names->len)->freq[j] = 0;
 			}
+
+			copy_name(NAME_AT(names, names->len)->name, tmp_name);
+			NAME_AT(names, names->len)->sex = tmp_sex;
+			NAME_AT(names, names->len)->freq[y] = tmp_freq;
+			names->len ++;
 		}
-	}	
+	}
+
+	ok = !sc->error;
+	scan_Close( sc);
+	fit_years( names);
+
+	return ok;
 }
 
-void load_names_bsearch( FILE *fp, int start_year, tNames *names){
+int load_names_bsearch( FILE *fp, tNames *names){
 	char tmp_name[20], tmp_sex;
-	int tmp_year, tmp_freq, tmp_len;
-	int pre_year = start_year;
-	tName* find;
-	tName* key;
+	int tmp_year, tmp_freq;
+	int first_year = 0, pre_year = 0; // 입력의 첫 연도, 직전 행의 연도
+	int y;
+	tKey *keys = NULL; // 정렬된 압축 키 배열 (이름 구조체 배열은 이동하지 않음)
+	int num_key = 0;
+	tKey key;
+	tKey *find;
+	int ok;
+	SCANNER *sc = scan_Open( fp);
+	tRecord rec;
+
+	if( sc == NULL) return 0;
 
-	while(!feof(fp)){
+	while( scan_Next( sc, &rec)){
 
-		fscanf( fp, "%d %s %c %d\n", &tmp_year, tmp_name, &tmp_sex, &tmp_freq);
+		tmp_year = rec.year;
+		scan_Copy( &rec, tmp_name, sizeof(tmp_name));
+		tmp_sex = rec.sex;
+		tmp_freq = rec.freq;
+
+		if( names->num_year == 0) first_year = pre_year = tmp_year;
+		y = year_index( names, tmp_year);
 
 		if( tmp_year != pre_year){
 			//연도 업데이트
 			pre_year = tmp_year;
-			tmp_len = names->len;
 
-			//연도가 바뀔 때 qsort
+			//연도가 바뀔 때 새로 추가된 이름의 키를 더하여 키 배열을 qsort
 			// qsort(정렬할 배열, 요소 개수, 요소 크기, 비교함수)
-			qsort(names->data, tmp_len, sizeof(tName), compare);
+			keys = (tKey *)realloc(keys, names->len * sizeof(tKey));
+			for (int i = num_key; i < names->len; i++){
+				make_key(NAME_AT(names, i)->name, NAME_AT(names, i)->sex, i, &keys[i]);
+			}
+			num_key = names->len;
+			radix_sort_keys(keys, num_key);
 		}
 
 		if( names->len == names->capacity){
 				names->capacity += 1000;
-				names->data = (tName *)realloc(names->data, names->capacity * sizeof(tName));
+				names->data = (tName *)realloc(names->data, names->capacity * names->rec_size);
 		}
 
-		if( tmp_year == start_year){ //2009년 데이터를 받아옴
+		if( tmp_year == first_year){ //첫 연도 데이터를 받아옴
 
-			for (int j = 0; j < 10; j++){
-                	names->data[names->len].freq[j] = 0;
+			for (int j = 0; j < names->num_year; j++){
+                	NAME_AT(names, names->len)->freq[j] = 0;
         	}
 
-			strcpy(names->data[names->len].name, tmp_name);
-			names->data[names->len].sex = tmp_sex;
-			names->data[names->len].freq[tmp_year - start_year] = tmp_freq;
+			copy_name(NAME_AT(names, names->len)->name, tmp_name);
+			NAME_AT(names, names->len)->sex = tmp_sex;
+			NAME_AT(names, names->len)->freq[y] = tmp_freq;
 			names->len ++;
 		}
 
-		// 2009년에는 이진탐색 생략
-		if (tmp_year == start_year) continue;
+		// 첫 연도에는 이진탐색 생략
+		if (tmp_year == first_year) continue;
 
-		key = (tName*)malloc(sizeof(tName));
-		
-		strcpy(key->name, tmp_name);
-		key->sex = tmp_sex;
-		key->freq[tmp_year-start_year] = tmp_freq;
+		make_key(tmp_name, tmp_sex, 0, &key);
 
 		// 이진탐색
 		// bsearch(검색할 요소 객체에 대한 포인터, 검색을 실행할 배열의 포인터, 배열의 요소 개수, 배열의 크기, 비교함수 포인터)
-		// 이진탐색의 범위를 새 연도 정보를 받기 전까지로 제함 -> tmp_len 활용
-		find = (tName*)bsearch(key, names->data, tmp_len, sizeof(tName), compare);
+		// 이진탐색의 범위를 새 연도 정보를 받기 전까지로 제함 -> num_key 활용
+		find = (tKey*)bsearch(&key, keys, num_key, sizeof(tKey), compare_key);
 		
 		if( find != NULL){ // 이름과 성별이 모두 같은 경우
-          find->freq[tmp_year - start_year] = key->freq[tmp_year - start_year];
+          NAME_AT(names, find->idx)->freq[y] = tmp_freq;
         }
 
 		else{ // 같은 이름이 없는 경우
 
-			for (int j = 0; j < 10; j++){
-                	names->data[names->len].freq[j] = 0;
+			for (int j = 0; j < names->num_year; j++){
+                	NAME_AT(names, names->len)->freq[j] = 0;
            	}
 
-			strcpy(names->data[names->len].name, tmp_name);
-			names->data[names->len].sex = tmp_sex;
-			names->data[names->len].freq[tmp_year - start_year] = tmp_freq;
+			copy_name(NAME_AT(names, names->len)->name, tmp_name);
+			NAME_AT(names, names->len)->sex = tmp_sex;
+			NAME_AT(names, names->len)->freq[y] = tmp_freq;
 			names->len ++;
 		}
+	}
+
+	ok = !sc->error;
+	free(keys);
+	scan_Close( sc);
+	fit_years( names);
+
+	return ok;
+}
+
+// FNV-1a 해시 (이름과 성별)
+static unsigned int hash_name( const char *name, char sex){
+	unsigned int h = 2166136261u;
 
-		free(key);
+	while(*name){
+		h ^= (unsigned char)*name++;
+		h *= 16777619u;
 	}
+	h ^= (unsigned char)sex;
+	h *= 16777619u;
+
+	return h;
+}
+
+// 키가 저장된 슬롯 또는 키가 저장되어야 할 빈 슬롯의 주소를 반환
+static int *hash_probe( tHash *hash, tNames *names, const char *name, char sex){
+	unsigned int mask = hash->size - 1;
+	unsigned int i = hash_name( name, sex) & mask;
+
+	while(hash->slot[i] != -1){
+		tName *p = NAME_AT(names, hash->slot[i]);
+
+		if( p->sex == sex && compare_name(p->name, name) == 0) break;
+		i = (i + 1) & mask;
+	}
+
+	return &hash->slot[i];
+}
+
+// 슬롯 수를 두 배로 늘리고 저장된 인덱스를 다시 배치
+static void hash_grow( tHash *hash, tNames *names){
+	int *old = hash->slot;
+	int old_size = hash->size;
+
+	hash->size *= 2;
+	hash->slot = (int *)malloc(hash->size * sizeof(int));
+	memset(hash->slot, -1, hash->size * sizeof(int));
+
+	for(int i = 0; i < old_size; i++){
+		if( old[i] == -1) continue;
+		*hash_probe( hash, names, NAME_AT(names, old[i])->name, NAME_AT(names, old[i])->sex) = old[i];
+	}
+
+	free(old);
+}
+
+tHash *create_hash( int size){
+	tHash *hash = (tHash *)malloc(sizeof(tHash));
+
+	hash->size = size;
+	hash->count = 0;
+	hash->slot = (int *)malloc(size * sizeof(int));
+	memset(hash->slot, -1, size * sizeof(int)); // 모든 바이트가 0xff -> -1
+
+	return hash;
+}
+
+void destroy_hash( tHash *hash){
+	free(hash->slot);
+	free(hash);
 }
 
-void print_names( tNames *names, int num_year){
-	int i , j;
+// 토크나이저로부터 해시 인덱스를 이용하여 이름 정보를 읽음
+// load_names_hash와 병렬 읽기 모드의 작업 스레드에서 사용
+static void _load_hash( SCANNER *sc, tNames *names){
+	char tmp_name[20], tmp_sex;
+	int tmp_year, tmp_freq;
+	int y;
+	tHash *hash = create_hash( 4096);
+	int *slot;
+	tRecord rec;
+
+	while( scan_Next( sc, &rec)){
+
+		tmp_year = rec.year;
+		scan_Copy( &rec, tmp_name, sizeof(tmp_name));
+		tmp_sex = rec.sex;
+		tmp_freq = rec.freq;
+
+		y = year_index( names, tmp_year);
+		slot = hash_probe( hash, names, tmp_name, tmp_sex);
 
-	for(i = 0; i < names->len; i++){
-		printf("%s	%c", names->data[i].name, names->data[i].sex);
+		if( *slot != -1){ // 이름과 성별이 모두 같은 경우
+			NAME_AT(names, *slot)->freq[y] = tmp_freq;
+			continue;
+		}
+
+		if( names->len == names->capacity){
+			names->capacity += 1000;
+			names->data = (tName *)realloc(names->data, names->capacity * names->rec_size);
+		}
 
-		for(j = 0; j < num_year; j++){
-			printf("	%d", names->data[i].freq[j]);
+		// 새로운 정보 추가
+		for (int j = 0; j < names->num_year; j++){
+			NAME_AT(names, names->len)->freq[j] = 0;
 		}
 
-		printf("\n");
+		copy_name(NAME_AT(names, names->len)->name, tmp_name);
+		NAME_AT(names, names->len)->sex = tmp_sex;
+		NAME_AT(names, names->len)->freq[y] = tmp_freq;
+
+		*slot = names->len;
+		names->len ++;
+
+		// load factor 0.5를 넘으면 슬롯 수를 늘림
+		if( ++hash->count * 2 > hash->size) hash_grow( hash, names);
 	}
+
+	destroy_hash( hash);
 }
 
-int compare( const void *n1, const void *n2){
-	tName t1 = *(tName*)n1;
-	tName t2 = *(tName*)n2;
+int load_names_hash( FILE *fp, tNames *names){
+	SCANNER *sc = scan_Open( fp);
+	int ok;
 
-	if( strcmp(t1.name, t2.name) == 0){
-		if(t1.sex == t2.sex) return 0;
-		else return (t1.sex > t2.sex) ? 1 : -1;
+	if( sc == NULL) return 0;
+
+	_load_hash( sc, names);
+
+	ok = !sc->error;
+	scan_Close( sc);
+	fit_years( names);
+
+	return ok;
+}
+
+// 이름(성별)의 1 byte 지문 (해시의 상위 8비트)
+static uint8_t fingerprint( const char *name, char sex){
+	return (uint8_t)(hash_name( name, sex) >> 24);
+}
+
+// 지문 배열 tag에서 지문이 t이고 이름과 성별이 같은 이름을 찾음
+// 지문은 AVX2 64개, SSE2 32개씩 비교하고, 같은 지문의 이름만 compare_name
+// return	이름 구조체 배열의 인덱스
+//			-1 not found
+static int _fingerprint_find( tNames *names, const uint8_t *tag, uint8_t t, const char *name, char sex){
+	int n = names->len, i = 0;
+
+#if defined(__AVX2__)
+	__m256i key = _mm256_set1_epi8((char)t);
+
+	for(; i + 64 <= n; i += 64){
+		uint64_t lo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(tag + i)), key));
+		uint64_t hi = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(tag + i + 32)), key));
+		uint64_t m = lo | (hi << 32);
+
+		for(; m; m &= m - 1){
+			tName *p = NAME_AT(names, i + __builtin_ctzll(m));
+			if( p->sex == sex && compare_name(p->name, name) == 0) return i + __builtin_ctzll(m);
+		}
 	}
-	else{
-		return strcmp(t1.name, t2.name);
+#elif defined(__SSE2__)
+	__m128i key = _mm_set1_epi8((char)t);
+
+	for(; i + 32 <= n; i += 32){
+		uint32_t lo = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(tag + i)), key));
+		uint32_t hi = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(tag + i + 16)), key));
+		uint32_t m = lo | (hi << 16);
+
+		for(; m; m &= m - 1){
+			tName *p = NAME_AT(names, i + __builtin_ctz(m));
+			if( p->sex == sex && compare_name(p->name, name) == 0) return i + __builtin_ctz(m);
+		}
+	}
+#endif
+
+	for(; i < n; i++){
+		if( tag[i] == t && NAME_AT(names, i)->sex == sex && compare_name(NAME_AT(names, i)->name, name) == 0) return i;
 	}
+
+	return -1;
 }
 
-// 이름 구조체를 초기화
-// len를 0으로, capacity를 1000으로 초기화
-// return : 구조체 포인터
-tNames *create_names(void)
-{
-	tNames *pnames = (tNames *)malloc( sizeof(tNames));
-	
-	pnames->len = 0;
-	pnames->capacity = 1000;
-	pnames->data = (tName *)malloc(pnames->capacity * sizeof(tName));
+int load_names_fingerprint( FILE *fp, tNames *names){
+	char tmp_name[20];
+	int first_year = 0; // 입력의 첫 연도 (첫 연도에는 중복된 이름이 없으므로 탐색 생략)
+	uint8_t *tag = (uint8_t *)malloc(names->capacity); // names->data와 나란한 지문 배열
+	int ok;
+	SCANNER *sc = scan_Open( fp);
+	tRecord rec;
 
-	return pnames;
+	if( sc == NULL){
+		free(tag);
+		return 0;
+	}
+
+	// 이미 저장된 이름의 지문
+	for(int i = 0; i < names->len; i++)
+		tag[i] = fingerprint( NAME_AT(names, i)->name, NAME_AT(names, i)->sex);
+
+	while( scan_Next( sc, &rec)){
+		uint8_t t;
+		int i = -1, y;
+
+		scan_Copy( &rec, tmp_name, sizeof(tmp_name));
+		t = fingerprint( tmp_name, rec.sex);
+
+		if( names->num_year == 0) first_year = rec.year;
+		y = year_index( names, rec.year);
+
+		if( rec.year != first_year) i = _fingerprint_find( names, tag, t, tmp_name, rec.sex);
+
+		if( i < 0){
+			tName *p;
+
+			if( names->len == names->capacity){
+				// capacity 가 부족하면 +1000
+				names->capacity += 1000;
+				names->data = (tName *)realloc(names->data, names->capacity * names->rec_size);
+				tag = (uint8_t *)realloc(tag, names->capacity);
+			}
+
+			// 새로운 정보 추가
+			p = NAME_AT(names, names->len);
+			memset(p->freq, 0, names->num_year * sizeof(int));
+			copy_name(p->name, tmp_name);
+			p->sex = rec.sex;
+			tag[names->len] = t;
+			i = names->len++;
+		}
+
+		NAME_AT(names, i)->freq[y] = rec.freq;
+	}
+
+	ok = !sc->error;
+	free(tag);
+	scan_Close( sc);
+	fit_years( names);
+
+	return ok;
 }
 
-// 이름 구조체에 할당된 메모리를 해제
-void destroy_names(tNames *pnames)
-{
+// 작업 스레드
+// 맡은 구간을 읽어 정렬된 run을 만듦
+static void *_load_worker( void *arg){
+	tWorker *w = (tWorker *)arg;
 
-	free(pnames->data);
-	pnames->len = 0;
-	pnames->capacity = 0;
+	_load_hash( &w->part, w->run);
+	sort_names( w->run);
 
-	free(pnames);
+	return NULL;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-int main(int argc, char **argv)
-{
-	tNames *names;
-	int option;
-	FILE *fp;
-	
-	if (argc != 3)
-	{
-		fprintf( stderr, "Usage: %s option FILE\n\n", argv[0]);
-		fprintf( stderr, "option\n\t-l\n\t\twith linear search\n\t-b\n\t\twith binary search\n");
-		return 1;
+// k-way merge를 위한 min-heap에서 idx번째 run을 아래로 내려 힙 속성을 복구
+// heap에는 run 번호, pos에는 run별 현재 위치가 저장됨
+static void _merge_down( int *heap, int size, int idx, tWorker *w, int *pos){
+	while(1){
+		int left = 2 * idx + 1, right = 2 * idx + 2, min = idx;
+
+		if( left < size && compare( NAME_AT(w[heap[left]].run, pos[heap[left]]), NAME_AT(w[heap[min]].run, pos[heap[min]])) < 0) min = left;
+		if( right < size && compare( NAME_AT(w[heap[right]].run, pos[heap[right]]), NAME_AT(w[heap[min]].run, pos[heap[min]])) < 0) min = right;
+		if( min == idx) break;
+
+		int tmp = heap[idx];
+		heap[idx] = heap[min];
+		heap[min] = tmp;
+		idx = min;
 	}
-	
-	if (strcmp( argv[1], "-l") == 0) option = LINEAR_SEARCH;
-	else if (strcmp( argv[1], "-b") == 0) option = BINARY_SEARCH;
-	else {
-		fprintf( stderr, "unknown option : %s\n", argv[1]);
-		return 1;
+}
+
+int load_names_parallel( FILE *fp, tNames *names){
+	SCANNER *sc = scan_Open( fp);
+	tWorker w[MAX_THREADS];
+	pthread_t tid[MAX_THREADS];
+	int started[MAX_THREADS];
+	int heap[MAX_THREADS], pos[MAX_THREADS];
+	int num_thread, size = 0, total = 0;
+	int first = 0, last = -1; // 모든 구간의 연도 범위
+	int ok = 1;
+
+	if( sc == NULL) return 0;
+
+	// 스레드 수: 코어 수 (입력이 작으면 구간당 최소 크기에 맞춰 줄임)
+	num_thread = (int)sysconf( _SC_NPROCESSORS_ONLN);
+	if( num_thread > (sc->end - sc->cur) / MIN_CHUNK + 1) num_thread = (sc->end - sc->cur) / MIN_CHUNK + 1;
+	if( num_thread > MAX_THREADS) num_thread = MAX_THREADS;
+	if( num_thread < 1) num_thread = 1;
+
+	for(int k = 0; k < num_thread; k++){
+		scan_Slice( sc, k, num_thread, &w[k].part);
+		w[k].run = create_names();
+
+		// 마지막 구간과 스레드를 만들지 못한 구간은 현재 스레드에서 처리
+		started[k] = (k < num_thread - 1 && pthread_create( &tid[k], NULL, _load_worker, &w[k]) == 0);
+		if( !started[k]) _load_worker( &w[k]);
 	}
-	
-	// 이름 구조체 초기화
-	names = create_names();
 
-	if ((fp = fopen( argv[2], "r")) == NULL) 
-	{
-		fprintf( stderr, "cannot open file : %s\n", argv[2]);
-		return 1;
+	for(int k = 0; k < num_thread; k++){
+		tNames *run;
+
+		if( started[k]) pthread_join( tid[k], NULL);
+
+		if( w[k].part.error) ok = 0; // 스트림 입력은 0번째 구간이 읽음
+		run = w[k].run;
+		total += run->len;
+		if( run->num_year == 0) continue;
+		if( first > last || run->start_year < first) first = run->start_year;
+		if( first > last || run->start_year + run->num_year - 1 > last) last = run->start_year + run->num_year - 1;
 	}
 
-	if (option == LINEAR_SEARCH)
-	{
-		// 연도별 입력 파일(이름 정보)을 구조체에 저장
-		// 선형탐색 모드
-		load_names_lsearch( fp, 2009, names);
+	// 결과 배열의 연도 범위를 모든 구간의 연도 범위로 넓힘
+	if( first <= last){
+		year_index( names, first);
+		year_index( names, last);
 	}
-	else // (option == BINARY_SEARCH)
-	{
-		// 이진탐색 모드
-		load_names_bsearch( fp, 2009, names);
+
+	// 결과 배열의 용량 확보 (1000 단위)
+	if( names->capacity < names->len + total){
+		names->capacity = (names->len + total + 999) / 1000 * 1000;
+		names->data = (tName *)realloc(names->data, names->capacity * names->rec_size);
 	}
 
-	// 정렬 (이름순 (이름이 같은 경우 성별순))
-	qsort( names->data, names->len, sizeof(tName), compare);
+	// k-way merge
+	for(int k = 0; k < num_thread; k++){
+		pos[k] = 0;
+		if( w[k].run->len > 0) heap[size++] = k;
+	}
+	for(int i = size / 2 - 1; i >= 0; i--)
+		_merge_down( heap, size, i, w, pos);
 
-	fclose( fp);
-		
-	// 이름 구조체를 화면에 출력
-	print_names( names, MAX_YEAR_DURATION);
+	while( size > 0){
+		int k = heap[0];
+		tName *p = NAME_AT(w[k].run, pos[k]);
+		int off = w[k].run->start_year - names->start_year; // 구간의 연도 인덱스 -> 결과의 연도 인덱스
+
+		if( names->len > 0 && compare( NAME_AT(names, names->len - 1), p) == 0){
+			// 다른 구간에서 이미 나온 이름이면 연도별 빈도를 합산
+			for (int j = 0; j < w[k].run->num_year; j++){
+				NAME_AT(names, names->len - 1)->freq[off + j] += p->freq[j];
+			}
+		}
+		else{
+			tName *q = NAME_AT(names, names->len);
+
+			memcpy(q, p, offsetof(tName, freq));
+			memset(q->freq, 0, names->num_year * sizeof(int));
+			memcpy(q->freq + off, p->freq, w[k].run->num_year * sizeof(int));
+			names->len ++;
+		}
+
+		// run의 다음 이름으로 이동 (run이 끝나면 힙에서 제거)
+		if( ++pos[k] == w[k].run->len) heap[0] = heap[--size];
+		_merge_down( heap, size, 0, w, pos);
+	}
+
+	for(int k = 0; k < num_thread; k++)
+		destroy_names( w[k].run);
+
+	scan_Close( sc);
+	fit_years( names);
+
+	return ok;
+}
+
+// 이름 한 줄을 출력 ("이름\t성별\t빈도...\n")
+static void _print_name( WRITER *out, const tName *p, int num_year){
+	out_Str( out, p->name);
+	out_Char( out, '\t');
+	out_Char( out, p->sex);
+
+	for(int j = 0; j < num_year; j++){
+		out_Char( out, '\t');
+		out_Int( out, p->freq[j]);
+	}
+
+	out_Char( out, '\n');
+}
+
+// 출력 스레드
+// 맡은 구간의 출력을 메모리 버퍼에 만듦
+static void *_print_worker( void *arg){
+	tPrinter *pr = (tPrinter *)arg;
+
+	for(int i = pr->from; i < pr->to; i++)
+		_print_name( pr->out, NAME_AT(pr->names, i), pr->names->num_year);
+
+	return NULL;
+}
+
+void print_names( tNames *names){
+	WRITER *out = out_Open( stdout);
+	int num_thread = 1;
+
+#if PARALLEL_PRINT
+	// 스레드 수: 코어 수 (이름이 적으면 스레드당 최소 이름의 수에 맞춰 줄임)
+	num_thread = (int)sysconf( _SC_NPROCESSORS_ONLN);
+	if( num_thread > names->len / MIN_PRINT_ROWS + 1) num_thread = names->len / MIN_PRINT_ROWS + 1;
+	if( num_thread > MAX_THREADS) num_thread = MAX_THREADS;
+	if( num_thread < 1) num_thread = 1;
+#endif
+
+	if( num_thread == 1){
+		for(int i = 0; i < names->len; i++)
+			_print_name( out, NAME_AT(names, i), names->num_year);
+	}
+	else{
+		tPrinter pr[MAX_THREADS];
+		pthread_t tid[MAX_THREADS];
+		int started[MAX_THREADS];
+
+		for(int k = 0; k < num_thread; k++){
+			pr[k].names = names;
+			pr[k].from = (int)((long long)names->len * k / num_thread);
+			pr[k].to = (int)((long long)names->len * (k + 1) / num_thread);
+			pr[k].out = out_Open( NULL);
+
+			// 스레드를 만들지 못한 구간은 현재 스레드에서 처리
+			started[k] = (pthread_create( &tid[k], NULL, _print_worker, &pr[k]) == 0);
+			if( !started[k]) _print_worker( &pr[k]);
+		}
+
+		// 구간 순서대로 내보냄
+		for(int k = 0; k < num_thread; k++){
+			if( started[k]) pthread_join( tid[k], NULL);
+
+			out_Mem( out, pr[k].out->buf, pr[k].out->len);
+			out_Close( pr[k].out);
+		}
+	}
+
+	out_Close( out);
+}
+
+int compare( const void *n1, const void *n2){
+	const tName *t1 = (const tName *)n1;
+	const tName *t2 = (const tName *)n2;
+	int ret = compare_name(t1->name, t2->name);
+
+	if( ret == 0){
+		if(t1->sex == t2->sex) return 0;
+		else return (t1->sex > t2->sex) ? 1 : -1;
+	}
+	else{
+		return ret;
+	}
+}
+
+int compare_name( const char *a, const char *b){
+	uint32_t ta, tb;
+
+#if defined(__SSE2__)
+	// 앞 16 bytes에서 처음으로 다른 바이트
+	unsigned diff = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)a), _mm_loadu_si128((const __m128i *)b))) ^ 0xFFFF;
+
+	if( diff){
+		int i = __builtin_ctz(diff);
+		return ((unsigned char)a[i] > (unsigned char)b[i]) ? 1 : -1;
+	}
+#else
+	uint64_t wa, wb;
+
+	for(int i = 0; i < 16; i += 8){
+		memcpy(&wa, a + i, 8);
+		memcpy(&wb, b + i, 8);
+		if( wa != wb) return (__builtin_bswap64(wa) > __builtin_bswap64(wb)) ? 1 : -1;
+	}
+#endif
+
+	// 나머지 4 bytes (big-endian으로 바꾸면 정수 비교가 바이트 순서 비교)
+	memcpy(&ta, a + 16, 4);
+	memcpy(&tb, b + 16, 4);
+	if( ta != tb) return (__builtin_bswap32(ta) > __builtin_bswap32(tb)) ? 1 : -1;
+
+	return 0;
+}
+
+void copy_name( char *dst, const char *src){
+	size_t len = strnlen(src, 19);
+
+	memcpy(dst, src, len);
+	memset(dst + len, 0, 20 - len);
+}
+
+void make_key( const char *name, char sex, uint32_t idx, tKey *key){
+	unsigned char b[20];
+	int i;
+
+	// 이름 뒤의 빈 칸은 0으로 채움 (짧은 이름이 앞에 오도록)
+	for (i = 0; i < 19 && name[i] != '\0'; i++) b[i] = (unsigned char)name[i];
+	for (; i < 19; i++) b[i] = 0;
+	b[19] = (unsigned char)sex;
+
+	key->hi = key->lo = 0;
+	for (i = 0; i < 8; i++) key->hi = (key->hi << 8) | b[i];
+	for (i = 8; i < 16; i++) key->lo = (key->lo << 8) | b[i];
+	key->tail = ((uint32_t)b[16] << 24) | ((uint32_t)b[17] << 16) | ((uint32_t)b[18] << 8) | b[19];
+	key->idx = idx;
+}
+
+int compare_key( const void *k1, const void *k2){
+	const tKey *a = (const tKey *)k1;
+	const tKey *b = (const tKey *)k2;
+
+	if (a->hi != b->hi) return (a->hi > b->hi) ? 1 : -1;
+	if (a->lo != b->lo) return (a->lo > b->lo) ? 1 : -1;
+	if (a->tail != b->tail) return (a->tail > b->tail) ? 1 : -1;
+	return 0;
+}
+
+// 압축 키의 d번째 자리 (0~18: 이름의 바이트, 19: 성별)
+static inline unsigned int _key_digit( const tKey *key, int d){
+	if (d < 8) return (unsigned int)(key->hi >> (56 - 8 * d)) & 0xff;
+	if (d < 16) return (unsigned int)(key->lo >> (56 - 8 * (d - 8))) & 0xff;
+	return (key->tail >> (24 - 8 * (d - 16))) & 0xff;
+}
+
+// 삽입 정렬 (작은 버킷)
+static void _insertion_sort_keys( tKey *keys, int n){
+	for (int i = 1; i < n; i++){
+		tKey tmp = keys[i];
+		int j = i - 1;
+
+		while (j >= 0 && compare_key(&keys[j], &tmp) > 0){
+			keys[j + 1] = keys[j];
+			j--;
+		}
+		keys[j + 1] = tmp;
+	}
+}
+
+// d번째 자리부터 MSD 기수 정렬 (tmp: n개 크기의 임시 배열)
+static void _radix_sort( tKey *keys, tKey *tmp, int n, int d){
+	int count[256] = { 0 };
+	int pos[256];
+	int start;
+
+	if (n <= RADIX_CUTOFF){
+		_insertion_sort_keys(keys, n);
+		return;
+	}
+	if (d == KEY_DIGITS) return; // 모든 자리가 같음
+
+	for (int i = 0; i < n; i++)
+		count[_key_digit(&keys[i], d)]++;
+
+	pos[0] = 0;
+	for (int b = 1; b < 256; b++)
+		pos[b] = pos[b - 1] + count[b - 1];
+
+	for (int i = 0; i < n; i++)
+		tmp[pos[_key_digit(&keys[i], d)]++] = keys[i];
+	memcpy(keys, tmp, n * sizeof(tKey));
+
+	// 버킷별로 다음 자리를 정렬
+	start = 0;
+	for (int b = 0; b < 256; b++){
+		if (count[b] > 1){
+			// 이름이 끝난 버킷(0)은 남은 이름 바이트가 모두 0이므로 성별 자리로 건너뜀
+			int next = (b == 0 && d < KEY_DIGITS - 1) ? KEY_DIGITS - 1 : d + 1;
+
+			_radix_sort(keys + start, tmp, count[b], next);
+		}
+		start += count[b];
+	}
+}
+
+void radix_sort_keys( tKey *keys, int n){
+	tKey *tmp;
+
+	if (n <= RADIX_CUTOFF){
+		_insertion_sort_keys(keys, n);
+		return;
+	}
+
+	tmp = (tKey *)malloc(n * sizeof(tKey));
+	_radix_sort(keys, tmp, n, 0);
+	free(tmp);
+}
+
+void sort_names( tNames *names){
+	tKey *keys = (tKey *)malloc(names->len * sizeof(tKey));
+	tName *data = (tName *)malloc(names->capacity * names->rec_size);
+
+	for (int i = 0; i < names->len; i++)
+		make_key(NAME_AT(names, i)->name, NAME_AT(names, i)->sex, i, &keys[i]);
+
+	radix_sort_keys(keys, names->len);
+
+	// 정렬된 순서대로 레코드를 한 번만 재배치
+	for (int i = 0; i < names->len; i++)
+		memcpy((char *)data + (size_t)i * names->rec_size, NAME_AT(names, keys[i].idx), names->rec_size);
+
+	free(names->data);
+	names->data = data;
+	free(keys);
+}
+
+// 정렬된 키를 중위 순회 순서로 Eytzinger 배열에 배치
+// return : 다음에 배치할 정렬된 키의 위치
+static int _eytzinger( const tKey *sorted, tKey *out, int i, int k, int n){
+	if (k <= n){
+		i = _eytzinger(sorted, out, i, 2 * k, n);
+		out[k] = sorted[i++];
+		i = _eytzinger(sorted, out, i, 2 * k + 1, n);
+	}
+	return i;
+}
+
+// a < b (분기 없는 비교)
+static inline int _key_less( const tKey *a, const tKey *b){
+	return (a->hi < b->hi) | ((a->hi == b->hi) & ((a->lo < b->lo) | ((a->lo == b->lo) & (a->tail < b->tail))));
+}
+
+// 탐색이 끝난 위치 k로부터 key 이상인 첫번째 노드를 찾아, 같은 키이면 인덱스를 반환
+static inline int _lookup_result( tFrozen *frozen, unsigned int k, const tKey *key){
+	k >>= __builtin_ffs(~k); // 마지막으로 오른쪽으로 내려가기 전의 노드
+
+	if (k == 0 || compare_key(&frozen->key[k], key) != 0) return -1;
+	return frozen->key[k].idx;
+}
+
+tFrozen *freeze_names( tNames *names){
+	tFrozen *frozen = (tFrozen *)malloc(sizeof(tFrozen));
+	tKey *sorted = (tKey *)malloc(names->len * sizeof(tKey));
+
+	for (int i = 0; i < names->len; i++)
+		make_key(NAME_AT(names, i)->name, NAME_AT(names, i)->sex, i, &sorted[i]);
+
+	frozen->len = names->len;
+	frozen->key = (tKey *)malloc((names->len + 1) * sizeof(tKey));
+	_eytzinger(sorted, frozen->key, 0, 1, names->len);
+
+	free(sorted);
+	return frozen;
+}
+
+void destroy_frozen( tFrozen *frozen){
+	free(frozen->key);
+	free(frozen);
+}
+
+int lookup_name( tFrozen *frozen, const char *name, char sex){
+	tKey key;
+	unsigned int k = 1;
+	unsigned int n = frozen->len;
+
+	make_key(name, sex, 0, &key);
+
+	while (k <= n){
+		// 두 단계 아래의 노드들 (4k ~ 4k+3)을 미리 읽어둠
+		__builtin_prefetch(frozen->key + 4 * k);
+		k = 2 * k + _key_less(&frozen->key[k], &key);
+	}
+
+	return _lookup_result(frozen, k, &key);
+}
+
+void lookup_names( tFrozen *frozen, const tQuery *query, int n, int *out){
+	tKey key[LOOKUP_BATCH];
+	unsigned int k[LOOKUP_BATCH];
+	unsigned int len = frozen->len;
+
+	for (int base = 0; base < n; base += LOOKUP_BATCH){
+		int m = (n - base < LOOKUP_BATCH) ? n - base : LOOKUP_BATCH;
+		int active = m;
+
+		for (int j = 0; j < m; j++){
+			make_key(query[base + j].name, query[base + j].sex, 0, &key[j]);
+			k[j] = 1;
+		}
+
+		// 모든 탐색을 한 단계씩 함께 진행
+		while (active > 0){
+			active = 0;
+			for (int j = 0; j < m; j++){
+				if (k[j] > len) continue;
+
+				__builtin_prefetch(frozen->key + 4 * k[j]);
+				k[j] = 2 * k[j] + _key_less(&frozen->key[k[j]], &key[j]);
+				active += (k[j] <= len);
+			}
+		}
+
+		for (int j = 0; j < m; j++)
+			out[base + j] = _lookup_result(frozen, k[j], &key[j]);
+	}
+}
+
+// 이름 구조체를 초기화
+// len를 0으로, capacity를 1000으로 초기화
+// return : 구조체 포인터
+tNames *create_names(void)
+{
+	tNames *pnames = (tNames *)malloc( sizeof(tNames));
+	
+	pnames->len = 0;
+	pnames->capacity = 1000;
+	pnames->start_year = 0;
+	pnames->num_year = 0;
+	pnames->rec_size = REC_SIZE(0);
+	pnames->data = (tName *)malloc(pnames->capacity * pnames->rec_size);
+	pnames->map_size = 0;
+
+	return pnames;
+}
+
+// 이름 구조체에 할당된 메모리를 해제
+void destroy_names(tNames *pnames)
+{
+
+	if (pnames->map_size > 0) munmap((char *)pnames->data - sizeof(tSnapHeader), pnames->map_size);
+	else free(pnames->data);
+	pnames->len = 0;
+	pnames->capacity = 0;
+
+	free(pnames);
+}
+
+void resize_years( tNames *names, int start_year, int num_year){
+	int rec_size = REC_SIZE(num_year);
+	char *data = (char *)malloc((size_t)names->capacity * rec_size);
+	// 이전 범위와 새 범위가 겹치는 연도 [lo, hi)
+	int lo = (start_year > names->start_year) ? start_year : names->start_year;
+	int hi = (start_year + num_year < names->start_year + names->num_year) ? start_year + num_year : names->start_year + names->num_year;
+
+	for (int i = 0; i < names->len; i++){
+		tName *src = NAME_AT(names, i);
+		tName *dst = (tName *)(data + (size_t)i * rec_size);
+
+		memcpy(dst, src, offsetof(tName, freq));
+		memset(dst->freq, 0, num_year * sizeof(int));
+		if (lo < hi) memcpy(dst->freq + (lo - start_year), src->freq + (lo - names->start_year), (hi - lo) * sizeof(int));
+	}
+
+	if (names->map_size > 0) munmap((char *)names->data - sizeof(tSnapHeader), names->map_size);
+	else free(names->data);
+
+	names->data = (tName *)data;
+	names->map_size = 0;
+	names->start_year = start_year;
+	names->num_year = num_year;
+	names->rec_size = rec_size;
+}
+
+int year_index( tNames *names, int year){
+	int first = names->start_year;
+	int last = names->start_year + names->num_year - 1;
+
+	if (names->num_year > 0 && year >= first && year <= last) return year - first;
+
+	// 범위를 (최소한 year까지) 두 배로 넓힘
+	if (names->num_year == 0) first = last = year;
+	else if (year < first) first = (year < last - 2 * names->num_year + 1) ? year : last - 2 * names->num_year + 1;
+	else last = (year > first + 2 * names->num_year - 1) ? year : first + 2 * names->num_year - 1;
+
+	resize_years( names, first, last - first + 1);
+
+	return year - names->start_year;
+}
+
+void fit_years( tNames *names){
+	int first = names->num_year, last = -1; // 빈도가 0이 아닌 첫번째, 마지막 연도 인덱스
+
+	for (int i = 0; i < names->len; i++){
+		tName *p = NAME_AT(names, i);
+
+		for (int y = 0; y < first; y++)
+			if (p->freq[y] != 0){
+				first = y;
+				break;
+			}
+		for (int y = names->num_year - 1; y > last; y--)
+			if (p->freq[y] != 0){
+				last = y;
+				break;
+			}
+	}
+
+	if (first > last) return; // 빈도가 있는 연도가 없음
+	if (first == 0 && last == names->num_year - 1) return;
+
+	resize_years( names, names->start_year + first, last - first + 1);
+}
+
+int save_names( tNames *names, const char *path){
+	tSnapHeader header;
+	char tmp_path[1024];
+	FILE *fp;
+	int ok;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = SNAPSHOT_VERSION;
+	header.count = names->len;
+	header.start_year = names->start_year;
+	header.num_year = names->num_year;
+	header.rec_size = names->rec_size;
+
+	snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+	if ((fp = fopen( tmp_path, "wb")) == NULL) return 0;
+
+	ok = (fwrite(&header, sizeof(header), 1, fp) == 1);
+	if (ok && names->len > 0) ok = (fwrite(names->data, names->rec_size, names->len, fp) == (size_t)names->len);
+	if (fclose( fp) != 0) ok = 0;
+
+	if (ok && rename(tmp_path, path) != 0) ok = 0;
+	if (!ok) remove(tmp_path);
+
+	return ok;
+}
+
+tNames *open_names( const char *path){
+	tNames *pnames;
+	tSnapHeader *header;
+	struct stat st;
+	void *map;
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0) return NULL;
+
+	if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(tSnapHeader)){
+		close(fd);
+		return NULL;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd); // 매핑은 파일을 닫아도 유지됨
+	if (map == MAP_FAILED) return NULL;
+
+	// 헤더 검사 (형식, 버전, 구조체 크기, 파일 크기)
+	header = (tSnapHeader *)map;
+	if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 || header->version < 1 || header->version > SNAPSHOT_VERSION
+		|| header->num_year < 0 || header->rec_size != (int)REC_SIZE(header->num_year) || header->count < 0
+		|| (off_t)(sizeof(tSnapHeader) + (size_t)header->count * header->rec_size) > st.st_size){
+		munmap(map, st.st_size);
+		return NULL;
+	}
+
+	pnames = (tNames *)malloc( sizeof(tNames));
+	pnames->len = header->count;
+	pnames->capacity = header->count;
+	pnames->data = (tName *)((char *)map + sizeof(tSnapHeader));
+	pnames->map_size = st.st_size;
+	pnames->start_year = header->start_year;
+	pnames->num_year = header->num_year;
+	pnames->rec_size = header->rec_size;
+
+	// 버전 1은 이름 뒤가 0으로 채워져 있다는 보장이 없으므로 메모리로 복사하여 채움
+	if (header->version == 1){
+		resize_years( pnames, pnames->start_year, pnames->num_year);
+
+		for (int i = 0; i < pnames->len; i++){
+			char *name = NAME_AT(pnames, i)->name;
+			size_t len = strnlen(name, 19);
+
+			memset(name + len, 0, 20 - len);
+		}
+	}
+
+	return pnames;
+}
+
+int append_names( tNames *names, FILE *fp){
+	SCANNER *sc = scan_Open( fp);
+	tRecord rec;
+	tName key;
+	tName *find, *p;
+	tHash *hash;
+	int *slot;
+	int old_len = names->len;
+	int ok;
+
+	if( sc == NULL) return 0;
+
+	// 스냅샷의 매핑은 수정할 수 없으므로 메모리로 복사
+	if( names->map_size > 0){
+		names->capacity = names->len + 1000;
+		resize_years( names, names->start_year, names->num_year);
+	}
+
+	// 새로 등장한 이름은 배열의 뒤에 추가하고 해시 인덱스로 중복을 확인
+	hash = create_hash( 1024);
+
+	while( scan_Next( sc, &rec)){
+		int year = year_index( names, rec.year); // 새 연도이면 범위를 넓힘
+
+		scan_Copy( &rec, key.name, sizeof(key.name));
+		key.sex = rec.sex;
+
+		// 기존 이름 (정렬된 앞부분)
+		find = (tName *)bsearch(&key, names->data, old_len, names->rec_size, compare);
+		if( find != NULL){
+			find->freq[year] = rec.freq;
+			continue;
+		}
+
+		// 새로 등장한 이름 (뒷부분)
+		slot = hash_probe( hash, names, key.name, key.sex);
+		if( *slot != -1){
+			NAME_AT(names, *slot)->freq[year] = rec.freq;
+			continue;
+		}
+
+		if( names->len == names->capacity){
+			names->capacity += 1000;
+			names->data = (tName *)realloc(names->data, names->capacity * names->rec_size);
+		}
+
+		p = NAME_AT(names, names->len);
+		memcpy(p, &key, offsetof(tName, freq));
+		memset(p->freq, 0, names->num_year * sizeof(int));
+		p->freq[year] = rec.freq;
+
+		*slot = names->len;
+		names->len ++;
+
+		if( ++hash->count * 2 > hash->size) hash_grow( hash, names);
+	}
+
+	ok = !sc->error;
+	destroy_hash( hash);
+	scan_Close( sc);
+	fit_years( names);
+
+	// 새로 등장한 이름들을 정렬한 후, 뒤에서부터 기존 배열과 병합
+	if( names->len > old_len){
+		int new_len = names->len - old_len;
+		int size = names->rec_size;
+		char *added = (char *)malloc((size_t)new_len * size);
+		int i = old_len - 1, j = new_len - 1, k = names->len - 1;
+
+		memcpy(added, NAME_AT(names, old_len), (size_t)new_len * size);
+		qsort(added, new_len, size, compare);
+
+		while( j >= 0){
+			if( i >= 0 && compare(NAME_AT(names, i), added + (size_t)j * size) > 0) memcpy(NAME_AT(names, k--), NAME_AT(names, i--), size);
+			else memcpy(NAME_AT(names, k--), added + (size_t)(j--) * size, size);
+		}
+
+		free(added);
+	}
+
+	return ok;
+}
+
+tNamesCol *create_names_col( tNames *names){
+	tNamesCol *cols = (tNamesCol *)malloc(sizeof(tNamesCol));
+	int n = names->len;
+
+	if(cols == NULL) return NULL;
+
+	cols->len = n;
+	cols->start_year = names->start_year;
+	cols->num_year = 0; // 할당된 빈도 열의 수 (overflow이면 destroy_names_col로 해제)
+	cols->name = (char (*)[20])malloc(n * sizeof(*cols->name));
+	cols->sex = (char *)malloc(n);
+	cols->freq = (int **)malloc(names->num_year * sizeof(int *));
+
+	if(cols->name == NULL || cols->sex == NULL || cols->freq == NULL){
+		destroy_names_col(cols);
+		return NULL;
+	}
+
+	for(; cols->num_year < names->num_year; cols->num_year++){
+		cols->freq[cols->num_year] = (int *)malloc(n * sizeof(int));
+		if(cols->freq[cols->num_year] == NULL){
+			destroy_names_col(cols);
+			return NULL;
+		}
+	}
+
+	for(int i = 0; i < n; i++){
+		memcpy(cols->name[i], NAME_AT(names, i)->name, sizeof(cols->name[i]));
+		cols->sex[i] = NAME_AT(names, i)->sex;
+
+		for(int y = 0; y < names->num_year; y++)
+			cols->freq[y][i] = NAME_AT(names, i)->freq[y];
+	}
+
+	return cols;
+}
+
+void destroy_names_col( tNamesCol *cols){
+	for(int y = 0; y < cols->num_year; y++)
+		free(cols->freq[y]);
+
+	free(cols->freq);
+	free(cols->name);
+	free(cols->sex);
+	free(cols);
+}
+
+long long col_sum( const int *col, int n){
+	long long sum = 0;
+	int i = 0;
+
+#if defined(__AVX2__)
+	__m256i acc = _mm256_setzero_si256();
+	long long part[4];
+
+	for(; i + 8 <= n; i += 8){
+		__m256i v = _mm256_loadu_si256((const __m256i *)(col + i));
+		// 32비트 -> 64비트 부호 확장 후 누적 (overflow 방지)
+		acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+		acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+	}
+	_mm256_storeu_si256((__m256i *)part, acc);
+	sum = part[0] + part[1] + part[2] + part[3];
+#elif defined(__SSE2__)
+	__m128i acc = _mm_setzero_si128();
+	long long part[2];
+
+	for(; i + 4 <= n; i += 4){
+		__m128i v = _mm_loadu_si128((const __m128i *)(col + i));
+		__m128i sign = _mm_srai_epi32(v, 31);
+		// 32비트 -> 64비트 부호 확장 후 누적 (overflow 방지)
+		acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+		acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+	}
+	_mm_storeu_si128((__m128i *)part, acc);
+	sum = part[0] + part[1];
+#endif
+
+	for(; i < n; i++)
+		sum += col[i];
+
+	return sum;
+}
+
+long long col_sum_sex( const int *col, const char *sex, int n, char s){
+	long long sum = 0;
+	int i = 0;
+
+#if defined(__AVX2__)
+	__m256i acc = _mm256_setzero_si256();
+	__m256i key = _mm256_set1_epi32((unsigned char)s);
+	long long part[4];
+
+	for(; i + 8 <= n; i += 8){
+		__m256i v = _mm256_loadu_si256((const __m256i *)(col + i));
+		// 성별 8바이트를 32비트 8개로 확장하여 마스크 생성
+		__m256i m = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(sex + i)));
+		v = _mm256_and_si256(v, _mm256_cmpeq_epi32(m, key));
+		acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+		acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+	}
+	_mm256_storeu_si256((__m256i *)part, acc);
+	sum = part[0] + part[1] + part[2] + part[3];
+#elif defined(__SSE2__)
+	__m128i acc = _mm_setzero_si128();
+	__m128i key = _mm_set1_epi32((unsigned char)s);
+	__m128i zero = _mm_setzero_si128();
+	long long part[2];
+
+	for(; i + 4 <= n; i += 4){
+		__m128i v = _mm_loadu_si128((const __m128i *)(col + i));
+		int s4;
+		__m128i m, sign;
+
+		// 성별 4바이트를 32비트 4개로 확장하여 마스크 생성
+		memcpy(&s4, sex + i, 4);
+		m = _mm_cvtsi32_si128(s4);
+		m = _mm_unpacklo_epi16(_mm_unpacklo_epi8(m, zero), zero);
+		v = _mm_and_si128(v, _mm_cmpeq_epi32(m, key));
+
+		sign = _mm_srai_epi32(v, 31);
+		acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+		acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+	}
+	_mm_storeu_si128((__m128i *)part, acc);
+	sum = part[0] + part[1];
+#endif
+
+	for(; i < n; i++)
+		if( sex[i] == s) sum += col[i];
+
+	return sum;
+}
+
+int col_min( const int *col, int n){
+	int min = INT_MAX;
+	int i = 0;
+
+#if defined(__AVX2__)
+	__m256i acc = _mm256_set1_epi32(INT_MAX);
+	__m256i zero = _mm256_setzero_si256();
+	int part[8];
+
+	for(; i + 8 <= n; i += 8){
+		__m256i v = _mm256_loadu_si256((const __m256i *)(col + i));
+		// 0인 칸은 INT_MAX로 바꿔 최소값에서 제외
+		v = _mm256_or_si256(v, _mm256_and_si256(_mm256_cmpeq_epi32(v, zero), acc));
+		acc = _mm256_min_epi32(acc, v);
+	}
+	_mm256_storeu_si256((__m256i *)part, acc);
+	for(int k = 0; k < 8; k++)
+		if( part[k] < min) min = part[k];
+#elif defined(__SSE2__)
+	__m128i acc = _mm_set1_epi32(INT_MAX);
+	__m128i inf = acc;
+	__m128i zero = _mm_setzero_si128();
+	int part[4];
+
+	for(; i + 4 <= n; i += 4){
+		__m128i v = _mm_loadu_si128((const __m128i *)(col + i));
+		__m128i gt;
+
+		// 0인 칸은 INT_MAX로 바꿔 최소값에서 제외
+		v = _mm_or_si128(v, _mm_and_si128(_mm_cmpeq_epi32(v, zero), inf));
+		// SSE2에는 min_epi32가 없으므로 비교 결과로 선택
+		gt = _mm_cmpgt_epi32(acc, v);
+		acc = _mm_or_si128(_mm_and_si128(gt, v), _mm_andnot_si128(gt, acc));
+	}
+	_mm_storeu_si128((__m128i *)part, acc);
+	for(int k = 0; k < 4; k++)
+		if( part[k] < min) min = part[k];
+#endif
+
+	for(; i < n; i++)
+		if( col[i] != 0 && col[i] < min) min = col[i];
+
+	return (min == INT_MAX) ? 0 : min;
+}
+
+int col_max( const int *col, int n){
+	int max = 0;
+	int i = 0;
+
+#if defined(__AVX2__)
+	__m256i acc = _mm256_setzero_si256();
+	int part[8];
+
+	for(; i + 8 <= n; i += 8)
+		acc = _mm256_max_epi32(acc, _mm256_loadu_si256((const __m256i *)(col + i)));
+
+	_mm256_storeu_si256((__m256i *)part, acc);
+	for(int k = 0; k < 8; k++)
+		if( part[k] > max) max = part[k];
+#elif defined(__SSE2__)
+	__m128i acc = _mm_setzero_si128();
+	int part[4];
+
+	for(; i + 4 <= n; i += 4){
+		__m128i v = _mm_loadu_si128((const __m128i *)(col + i));
+		__m128i gt = _mm_cmpgt_epi32(v, acc);
+
+		acc = _mm_or_si128(_mm_and_si128(gt, v), _mm_andnot_si128(gt, acc));
+	}
+	_mm_storeu_si128((__m128i *)part, acc);
+	for(int k = 0; k < 4; k++)
+		if( part[k] > max) max = part[k];
+#endif
+
+	for(; i < n; i++)
+		if( col[i] > max) max = col[i];
+
+	return max;
+}
+
+void year_stat( tNamesCol *cols, int year, tYearStat *stat){
+	const int *col = cols->freq[year];
+
+	stat->total = col_sum( col, cols->len);
+	stat->female = col_sum_sex( col, cols->sex, cols->len, 'F');
+	stat->male = col_sum_sex( col, cols->sex, cols->len, 'M');
+	stat->min = col_min( col, cols->len);
+	stat->max = col_max( col, cols->len);
+}
+
+void print_stats( tNamesCol *cols){
+	tYearStat stat;
+
+	printf("year\ttotal\tmale\tfemale\tmin\tmax\n");
+
+	for(int y = 0; y < cols->num_year; y++){
+		year_stat( cols, y, &stat);
+		printf("%d\t%lld\t%lld\t%lld\t%d\t%d\n", cols->start_year + y, stat.total, stat.male, stat.female, stat.min, stat.max);
+	}
+}
+
+// 상위 k개 힙의 비교 함수
+// 순위가 낮은 원소(빈도가 작거나, 빈도가 같으면 정렬 순서가 뒤인 원소)가 루트로 올라감 (최소 힙)
+static int _compare_top( void *t1, void *t2){
+	const tTop *a = (const tTop *)t1;
+	const tTop *b = (const tTop *)t2;
+
+	if (a->freq != b->freq) return (a->freq < b->freq) ? 1 : -1;
+	return a->idx - b->idx;
+}
+
+int top_names( tNamesCol *cols, int k){
+	int num_year = cols->num_year;
+	HEAP *(*heap)[2];
+	tTop *pool;
+	tTop **rank;
+	int num_heap = 0; // 생성된 힙의 수
+
+	if (k > cols->len) k = (cols->len > 0) ? cols->len : 1;
+
+	heap = (HEAP *(*)[2])malloc(num_year * sizeof(*heap)); // [연도][0: 남자, 1: 여자]
+	pool = (tTop *)malloc((size_t)num_year * 2 * k * sizeof(tTop));
+	rank = (tTop **)malloc(k * sizeof(tTop *));
+
+	if (heap != NULL && pool != NULL && rank != NULL){
+		for (; num_heap < num_year * 2; num_heap++){
+			heap[num_heap / 2][num_heap % 2] = heap_Create( k, _compare_top);
+			if (heap[num_heap / 2][num_heap % 2] == NULL) break;
+		}
+	}
+
+	// overflow: 생성된 힙만 해제
+	if (num_heap < num_year * 2){
+		for (int i = 0; i < num_heap; i++)
+			heap_Destroy( heap[i / 2][i % 2]);
+
+		free(rank);
+		free(pool);
+		free(heap);
+		return 0;
+	}
+
+	// 열 한 번 순회
+	for (int i = 0; i < cols->len; i++){
+		int s = (cols->sex[i] == 'F');
+
+		for (int y = 0; y < num_year; y++){
+			HEAP *h = heap[y][s];
+			tTop *top;
+			int freq = cols->freq[y][i];
+
+			if (freq == 0) continue;
+
+			if (h->last + 1 < k){
+				// 힙이 차지 않았으면 원소 슬롯을 새로 사용
+				top = &pool[((size_t)y * 2 + s) * k + h->last + 1];
+			}
+			else {
+				// 루트(현재 k번째)보다 빈도가 커야 교체 (빈도가 같으면 앞선 이름이 이미 들어 있음)
+				if (freq <= ((tTop *)h->heapArr[0])->freq) continue;
+				heap_Delete( h, (void **)&top);
+			}
+
+			top->freq = freq;
+			top->idx = i;
+			heap_Insert( h, top);
+		}
+	}
+
+	for (int y = 0; y < num_year; y++){
+		for (int s = 0; s < 2; s++){
+			int n = 0;
+
+			// 루트부터 꺼내면 순위가 낮은 순서
+			while (heap_Delete( heap[y][s], (void **)&rank[n])) n++;
+
+			for (int r = 0; r < n; r++){
+				tTop *top = rank[n - 1 - r];
+
+				printf("%d\t%c\t%d\t%s\t%d\n", cols->start_year + y, s ? 'F' : 'M', r + 1, cols->name[top->idx], top->freq);
+			}
+
+			// 원소는 pool에 있으므로 빈 힙만 해제
+			heap_Destroy( heap[y][s]);
+		}
+	}
+
+	free(rank);
+	free(pool);
+	free(heap);
+
+	return 1;
+}
+
+tPrefixSum *create_prefix_sum( tNames *names){
+	tPrefixSum *ps = (tPrefixSum *)malloc(sizeof(tPrefixSum));
+
+	if (ps == NULL) return NULL;
+
+	ps->len = names->len;
+	ps->num_year = 0; // 만들어진 누적 빈도 열의 수 (overflow이면 destroy_prefix_sum으로 해제)
+	ps->sum = (long long **)malloc(names->num_year * sizeof(long long *));
+
+	if (ps->sum == NULL){
+		free(ps);
+		return NULL;
+	}
+
+	for (int y = 0; y < names->num_year; y++){
+		long long *sum = (long long *)malloc((names->len + 1) * sizeof(long long));
+
+		if (sum == NULL){
+			destroy_prefix_sum(ps);
+			return NULL;
+		}
+
+		sum[0] = 0;
+		for (int i = 0; i < names->len; i++)
+			sum[i + 1] = sum[i] + NAME_AT(names, i)->freq[y];
+
+		ps->sum[y] = sum;
+		ps->num_year++;
+	}
+
+	return ps;
+}
+
+void destroy_prefix_sum( tPrefixSum *ps){
+	for (int y = 0; y < ps->num_year; y++)
+		free(ps->sum[y]);
+
+	free(ps->sum);
+	free(ps);
+}
+
+int lower_name( tNames *names, const char *key){
+	int lo = 0, hi = names->len;
+	char k[20];
+	int longer = (strlen(key) > 19); // 19자보다 긴 key는 앞 19자가 같은 이름보다 큼
+
+	copy_name(k, key);
+
+	while (lo < hi){
+		int mid = (lo + hi) / 2;
+		int ret = compare_name(NAME_AT(names, mid)->name, k);
+
+		if (ret < 0 || (ret == 0 && longer)) lo = mid + 1;
+		else hi = mid;
+	}
+
+	return lo;
+}
+
+void prefix_range( tNames *names, const char *prefix, int *lo, int *hi){
+	size_t plen = strlen(prefix);
+	int l, h;
+
+	// prefix 이상인 첫번째 이름 (prefix로 시작하는 이름 중 가장 앞)
+	*lo = lower_name( names, prefix);
+
+	// 앞 plen 글자가 prefix보다 큰 첫번째 이름 (upper bound)
+	l = *lo;
+	h = names->len;
+	while (l < h){
+		int mid = (l + h) / 2;
+
+		if (strncmp(NAME_AT(names, mid)->name, prefix, plen) <= 0) l = mid + 1;
+		else h = mid;
+	}
+
+	*hi = l;
+}
+
+long long range_sum( tPrefixSum *ps, int lo, int hi, int year){
+	return ps->sum[year][hi] - ps->sum[year][lo];
+}
+
+// 제어 바이트별 pshufb 셔플 마스크와 값 바이트 수
+static uint8_t _z_shuf[256][16] __attribute__((aligned(16)));
+static uint8_t _z_len[256];
+
+static void _z_init(void){
+	static int done = 0;
+
+	if (done) return;
+
+	for (int c = 0; c < 256; c++){
+		int pos = 0;
+
+		for (int j = 0; j < 4; j++){
+			int n = ((c >> (2 * j)) & 3) + 1;
+
+			for (int b = 0; b < 4; b++)
+				_z_shuf[c][4 * j + b] = (b < n) ? pos + b : 0x80; // 0x80 : 0으로 채움
+			pos += n;
+		}
+		_z_len[c] = pos;
+	}
+	done = 1;
+}
+
+// 빈도 행 하나를 압축하여 out에 저장
+// return : 저장한 바이트 수
+static int _z_encode_row( const int *freq, int num_year, uint8_t *out){
+	int nb = (num_year + 7) / 8;
+	int k = 0;
+	uint8_t *ctrl, *p;
+
+	memset(out, 0, nb);
+	for (int y = 0; y < num_year; y++)
+		if (freq[y] != 0){
+			out[y >> 3] |= 1 << (y & 7);
+			k++;
+		}
+
+	ctrl = out + nb;
+	memset(ctrl, 0, (k + 3) / 4);
+	p = ctrl + (k + 3) / 4;
+
+	k = 0;
+	for (int y = 0; y < num_year; y++){
+		uint32_t v = (uint32_t)freq[y];
+		int n;
+
+		if (v == 0) continue;
+
+		n = (v < (1u << 8)) ? 1 : (v < (1u << 16)) ? 2 : (v < (1u << 24)) ? 3 : 4;
+		ctrl[k >> 2] |= (n - 1) << (2 * (k & 3));
+		memcpy(p, &v, n); // little endian
+		p += n;
+		k++;
+	}
+
+	return p - out;
+}
+
+// 제어 바이트와 값 바이트들로부터 k개의 값을 vals에 풂
+// return : 행의 끝 위치
+static const uint8_t *_z_decode_vals( const uint8_t *p, int k, uint32_t *vals){
+	const uint8_t *ctrl = p;
+	int nc = (k + 3) / 4;
+
+	p += nc;
+	for (int c = 0; c < nc; c++){
+#if defined(__SSSE3__)
+		__m128i v = _mm_loadu_si128((const __m128i *)p);
+
+		_mm_storeu_si128((__m128i *)(vals + 4 * c), _mm_shuffle_epi8(v, _mm_load_si128((const __m128i *)_z_shuf[ctrl[c]])));
+		p += _z_len[ctrl[c]];
+#else
+		for (int j = 0; j < 4; j++){
+			int n = ((ctrl[c] >> (2 * j)) & 3) + 1;
+			uint32_t x = 0;
+
+			memcpy(&x, p, n);
+			vals[4 * c + j] = x;
+			p += n;
+		}
+#endif
+	}
+
+	// 마지막 제어 바이트의 사용하지 않는 자리는 1 byte로 계산되었으므로 되돌림
+	if (k & 3) p -= 4 - (k & 3);
+
+	return p;
+}
+
+// 압축 행 하나를 freq에 풂
+// return : 다음 행의 시작 위치
+static const uint8_t *_z_decode_row( tNamesZ *z, const uint8_t *p, int *freq){
+	const uint8_t *end;
+	int nb = (z->num_year + 7) / 8;
+	int k = 0, j = 0;
+
+	for (int b = 0; b < nb; b++)
+		k += __builtin_popcount(p[b]);
+
+	end = _z_decode_vals(p + nb, k, z->vals);
+	for (int y = 0; y < z->num_year; y++)
+		freq[y] = ((p[y >> 3] >> (y & 7)) & 1) ? (int)z->vals[j++] : 0;
+
+	return end;
+}
+
+tNamesZ *create_names_z( tNames *names){
+	tNamesZ *z = (tNamesZ *)malloc(sizeof(tNamesZ));
+	int n = names->len;
+	int num_year = names->num_year;
+	size_t max_row = (num_year + 7) / 8 + (num_year + 3) / 4 + 4 * num_year;
+
+	_z_init();
+
+	z->len = n;
+	z->start_year = names->start_year;
+	z->num_year = num_year;
+	z->vals = (uint32_t *)malloc((num_year + 3) / 4 * 4 * sizeof(uint32_t));
+	z->name = (char (*)[20])malloc(n * sizeof(*z->name));
+	z->sex = (char *)malloc(n);
+	z->block = (size_t *)malloc(((n + ZBLOCK - 1) / ZBLOCK + 1) * sizeof(size_t));
+	z->data = (uint8_t *)malloc(n * max_row + 16);
+	z->size = 0;
+
+	for (int i = 0; i < n; i++){
+		memcpy(z->name[i], NAME_AT(names, i)->name, sizeof(z->name[i]));
+		z->sex[i] = NAME_AT(names, i)->sex;
+
+		if (i % ZBLOCK == 0) z->block[i / ZBLOCK] = z->size;
+		z->size += _z_encode_row(NAME_AT(names, i)->freq, num_year, z->data + z->size);
+	}
+
+	// 디코딩 시 16 bytes 단위로 읽으므로 끝에 여유 공간을 둠
+	memset(z->data + z->size, 0, 16);
+	z->data = (uint8_t *)realloc(z->data, z->size + 16);
+
+	return z;
+}
+
+void destroy_names_z( tNamesZ *z){
+	free(z->vals);
+	free(z->data);
+	free(z->block);
+	free(z->name);
+	free(z->sex);
+	free(z);
+}
+
+void z_get( tNamesZ *z, int i, int *freq){
+	const uint8_t *p = z->data + z->block[i / ZBLOCK];
+	int nb = (z->num_year + 7) / 8;
+
+	// 블록의 시작부터 i번째 행 앞까지 건너뜀
+	for (int r = i - i % ZBLOCK; r < i; r++){
+		int k = 0;
+
+		for (int b = 0; b < nb; b++)
+			k += __builtin_popcount(p[b]);
+		p = _z_decode_vals(p + nb, k, z->vals);
+	}
+
+	_z_decode_row(z, p, freq);
+}
+
+void z_year_sums( tNamesZ *z, long long *sum){
+	const uint8_t *p = z->data;
+	int *freq = (int *)malloc(z->num_year * sizeof(int));
+
+	for (int y = 0; y < z->num_year; y++)
+		sum[y] = 0;
+
+	for (int i = 0; i < z->len; i++){
+		p = _z_decode_row(z, p, freq);
+
+		for (int y = 0; y < z->num_year; y++)
+			sum[y] += freq[y];
+	}
+
+	free(freq);
+}
+
+// 압축 구조체의 i번째 이름을 풀어 둔 빈도 freq와 함께 출력
+static void _print_name_z( WRITER *out, tNamesZ *z, int i, const int *freq){
+	out_Str(out, z->name[i]);
+	out_Char(out, '\t');
+	out_Char(out, z->sex[i]);
+	for (int y = 0; y < z->num_year; y++){
+		out_Char(out, '\t');
+		out_Int(out, freq[y]);
+	}
+	out_Char(out, '\n');
+}
+
+void print_names_z( tNamesZ *z){
+	const uint8_t *p = z->data;
+	int *freq = (int *)malloc(z->num_year * sizeof(int));
+	WRITER *out = out_Open(stdout);
+
+	for (int i = 0; i < z->len; i++){
+		p = _z_decode_row(z, p, freq);
+		_print_name_z(out, z, i, freq);
+	}
+
+	out_Close(out);
+	free(freq);
+}
+
+// 이름 구조체 배열의 i번째 이름과 압축 키 key의 비교 (query_Gallop)
+static int _compare_at( const void *table, int i, const void *key){
+	const tName *p = NAME_AT((const tNames *)table, i);
+	tKey k;
+
+	make_key(p->name, p->sex, i, &k);
+	return compare_key(&k, key);
+}
+
+// 압축 구조체의 i번째 이름과 압축 키 key의 비교 (query_Gallop)
+static int _compare_at_z( const void *table, int i, const void *key){
+	const tNamesZ *z = (const tNamesZ *)table;
+	tKey k;
+
+	make_key(z->name[i], z->sex[i], i, &k);
+	return compare_key(&k, key);
+}
+
+// 배치를 압축 키로 정렬한 후 정렬된 배열(len개)과 한 번의 병합 순회(galloping)로 답함
+// keys : 정렬에 사용할 압축 키 버퍼 (n개)
+static void _gallop_batch( const void *table, int len, int (*compare)( const void *table, int i, const void *key), tKey *keys, const tQuery *query, int n, int *found){
+	int pos = 0;
+
+	for (int i = 0; i < n; i++)
+		make_key(query[i].name, query[i].sex, i, &keys[i]);
+	radix_sort_keys(keys, n);
+
+	for (int i = 0; i < n; i++){
+		pos = query_Gallop(table, pos, len, &keys[i], compare);
+		found[keys[i].idx] = (pos < len && compare(table, pos, &keys[i]) == 0) ? pos : -1;
+	}
+}
+
+// 정렬된 이름 구조체 배열에서 답함 (galloping)
+static void _answer_gallop( void *table, const tQuery *query, int n, int *found){
+	tQueryTable *t = (tQueryTable *)table;
+
+	_gallop_batch(t->names, t->names->len, _compare_at, t->keys, query, n, found);
+}
+
+// 압축 구조체의 이름, 성별 열에서 답함 (galloping)
+static void _answer_gallop_z( void *table, const tQuery *query, int n, int *found){
+	tQueryTableZ *t = (tQueryTableZ *)table;
+
+	_gallop_batch(t->z, t->z->len, _compare_at_z, t->keys, query, n, found);
+}
+
+// 조회 전용 인덱스에서 조회마다 하나씩 탐색
+static void _answer_lookup( void *table, const tQuery *query, int n, int *found){
+	tFrozen *frozen = ((tQueryTable *)table)->frozen;
+
+	for (int i = 0; i < n; i++)
+		found[i] = lookup_name(frozen, query[i].name, query[i].sex);
+}
+
+// 조회 전용 인덱스에서 LOOKUP_BATCH개씩 함께 탐색
+static void _answer_lookup_batch( void *table, const tQuery *query, int n, int *found){
+	lookup_names(((tQueryTable *)table)->frozen, query, n, found);
+}
+
+// 찾은 이름을 출력 (연도별 빈도)
+static void _print_found( WRITER *out, void *table, int idx){
+	tQueryTable *t = (tQueryTable *)table;
+
+	_print_name(out, NAME_AT(t->names, idx), t->names->num_year);
+}
+
+void query_names( tNames *names, FILE *in){
+	static const tQueryMethod method[] = {
+		{ "gallop", _answer_gallop },
+		{ "eytzinger", _answer_lookup },
+		{ "eytzinger batch", _answer_lookup_batch },
+	};
+	tQueryTable table;
+	struct timespec t0, t1;
+
+	table.names = names;
+	table.keys = (tKey *)malloc(QUERY_BATCH * sizeof(tKey));
+	if (table.keys == NULL) return;
+
+	// 조회 전용 인덱스는 한 번만 생성
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	table.frozen = freeze_names(names);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	fprintf(stderr, "freeze: %d names, %.2f ms\n", names->len, query_Elapsed(&t0, &t1) * 1e3);
+
+	query_Run(in, &table, method, sizeof(method) / sizeof(method[0]), _print_found);
+
+	destroy_frozen(table.frozen);
+	free(table.keys);
+}
+
+// 찾은 이름의 행만 풀어서 출력 (z_get)
+static void _print_found_z( WRITER *out, void *table, int idx){
+	tQueryTableZ *t = (tQueryTableZ *)table;
+
+	z_get(t->z, idx, t->freq);
+	_print_name_z(out, t->z, idx, t->freq);
+}
+
+void query_names_z( tNamesZ *z, FILE *in){
+	static const tQueryMethod method[] = {
+		{ "gallop (compressed)", _answer_gallop_z },
+	};
+	tQueryTableZ table;
+
+	table.z = z;
+	table.keys = (tKey *)malloc(QUERY_BATCH * sizeof(tKey));
+	table.freq = (int *)malloc((z->num_year + 1) * sizeof(int));
+	if (table.keys != NULL && table.freq != NULL)
+		query_Run(in, &table, method, sizeof(method) / sizeof(method[0]), _print_found_z);
+
+	free(table.freq);
+	free(table.keys);
+}
+
+// path가 스냅샷이면 매핑하고, 아니면 입력 파일을 해시 인덱스 모드로 읽어 정렬
+// return	이름 구조체 포인터
+//			NULL if failed
+static tNames *_open_sorted( const char *path){
+	tNames *names;
+	FILE *fp;
+
+	if ((names = open_names( path)) != NULL) return names;
+
+	if ((fp = fopen( path, "r")) == NULL){
+		fprintf( stderr, "cannot open file : %s\n", path);
+		return NULL;
+	}
+
+	names = create_names();
+	if( !load_names_hash( fp, names)){
+		fprintf( stderr, "cannot read file : %s\n", path);
+		destroy_names( names);
+		fclose( fp);
+		return NULL;
+	}
+	sort_names( names);
+	fclose( fp);
+
+	return names;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+	tNames *names;
+	int option;
+	int ok;
+	FILE *fp;
+	
+	if (argc != 3 && argc != 4)
+	{
+		fprintf( stderr, "Usage: %s option FILE [SNAPSHOT]\n", argv[0]);
+		fprintf( stderr, "       %s -a SNAPSHOT FILE\n", argv[0]);
+		fprintf( stderr, "       %s -q FILE [QUERY]\n", argv[0]);
+		fprintf( stderr, "       %s -k FILE [K]\n", argv[0]);
+		fprintf( stderr, "       %s -r FILE PREFIX|FROM..TO\n", argv[0]);
+		fprintf( stderr, "       %s -z FILE [QUERY]\n\n", argv[0]);
+		fprintf( stderr, "option\n\t-l\n\t\twith linear search\n\t-f\n\t\twith linear search over 1-byte fingerprints (SIMD)\n\t-b\n\t\twith binary search\n\t-h\n\t\twith hash index\n\t-p\n\t\twith parallel loading\n\t-s\n\t\tper-year statistics\n\t-m\n\t\tFILE is a snapshot\n\t-a\n\t\tappends FILE (new years) to SNAPSHOT\n\t-q\n\t\tanswers \"name sex\" queries from QUERY (or stdin) against FILE (snapshot or input file)\n\t-k\n\t\tprints the top K (default 10) names per year and sex in FILE (snapshot or input file)\n\t-r\n\t\tprints per-year totals of the names starting with PREFIX (or in [FROM, TO))\n\t-z\n\t\tprints FILE (snapshot or input file) through compressed frequency rows, or answers \"name sex\" queries from QUERY with them\n");
+		fprintf( stderr, "SNAPSHOT\n\tsaves the sorted names to a snapshot file\n");
+		return 1;
+	}
+	
+	if (strcmp( argv[1], "-l") == 0) option = LINEAR_SEARCH;
+	else if (strcmp( argv[1], "-f") == 0) option = FINGERPRINT;
+	else if (strcmp( argv[1], "-b") == 0) option = BINARY_SEARCH;
+	else if (strcmp( argv[1], "-h") == 0) option = HASH_SEARCH;
+	else if (strcmp( argv[1], "-p") == 0) option = PARALLEL;
+	else if (strcmp( argv[1], "-s") == 0) option = STATISTICS;
+	else if (strcmp( argv[1], "-m") == 0) option = SNAPSHOT;
+	else if (strcmp( argv[1], "-a") == 0) option = APPEND;
+	else if (strcmp( argv[1], "-q") == 0) option = QUERY;
+	else if (strcmp( argv[1], "-k") == 0) option = TOP_K;
+	else if (strcmp( argv[1], "-r") == 0) option = RANGE;
+	else if (strcmp( argv[1], "-z") == 0) option = COMPRESSED;
+	else {
+		fprintf( stderr, "unknown option : %s\n", argv[1]);
+		return 1;
+	}
+	
+	if (option == COMPRESSED)
+	{
+		tNamesZ *z;
+		long long *sum;
+		struct timespec t0, t1;
+		size_t raw, packed;
+
+		// FILE이 스냅샷이면 매핑하고, 아니면 입력 파일을 읽어 정렬
+		if ((names = _open_sorted( argv[2])) == NULL) return 1;
+
+		// 압축 후에는 원래의 이름 구조체가 필요 없음
+		z = create_names_z( names);
+		destroy_names( names);
+
+		raw = (size_t)z->len * z->num_year * sizeof(int);
+		packed = z->size + ((z->len + ZBLOCK - 1) / ZBLOCK + 1) * sizeof(size_t);
+
+		fprintf( stderr, "frequency rows: %zu bytes -> %zu bytes (%.1fx), %.2f bytes/name\n", raw, packed, packed ? (double)raw / packed : 0.0, z->len ? (double)packed / z->len : 0.0);
+
+		// QUERY가 있으면 압축된 행에서 조회에 답함
+		if (argc == 4)
+		{
+			FILE *in;
+
+			if ((in = fopen( argv[3], "r")) == NULL)
+			{
+				fprintf( stderr, "cannot open file : %s\n", argv[3]);
+				destroy_names_z( z);
+				return 1;
+			}
+
+			query_names_z( z, in);
+
+			fclose( in);
+			destroy_names_z( z);
+			return 0;
+		}
+
+		if ((sum = (long long *)malloc(z->num_year * sizeof(long long))) == NULL)
+		{
+			fprintf( stderr, "out of memory\n");
+			destroy_names_z( z);
+			return 1;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		z_year_sums( z, sum);
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		free(sum);
+
+		fprintf( stderr, "yearly totals scan: %.2f ms (%.0f names/s)\n", query_Elapsed(&t0, &t1) * 1e3, z->len / query_Elapsed(&t0, &t1));
+
+		print_names_z( z);
+
+		destroy_names_z( z);
+		return 0;
+	}
+
+	if (option == RANGE)
+	{
+		tPrefixSum *ps;
+		char *to;
+		int lo, hi;
+
+		if (argc != 4)
+		{
+			fprintf( stderr, "Usage: %s -r FILE PREFIX|FROM..TO\n\n", argv[0]);
+			return 1;
+		}
+
+		// FILE이 스냅샷이면 매핑하고, 아니면 입력 파일을 읽어 정렬
+		if ((names = _open_sorted( argv[2])) == NULL) return 1;
+
+		if ((ps = create_prefix_sum( names)) == NULL)
+		{
+			fprintf( stderr, "out of memory\n");
+			destroy_names( names);
+			return 1;
+		}
+
+		// FROM..TO 형식이면 사전순 구간 [FROM, TO), 아니면 접두사 구간
+		if ((to = strstr( argv[3], "..")) != NULL)
+		{
+			*to = '\0';
+			lo = lower_name( names, argv[3]);
+			hi = lower_name( names, to + 2);
+			if (hi < lo) hi = lo;
+			printf("[%s, %s)\t%d names\n", argv[3], to + 2, hi - lo);
+		}
+		else
+		{
+			prefix_range( names, argv[3], &lo, &hi);
+			printf("%s*\t%d names\n", argv[3], hi - lo);
+		}
+
+		for (int y = 0; y < names->num_year; y++)
+			printf("%d\t%lld\n", names->start_year + y, range_sum( ps, lo, hi, y));
+
+		destroy_prefix_sum( ps);
+		destroy_names( names);
+		return 0;
+	}
+
+	if (option == TOP_K)
+	{
+		tNamesCol *cols;
+		int k = (argc == 4) ? atoi( argv[3]) : 10;
+
+		if (k <= 0)
+		{
+			fprintf( stderr, "invalid K : %s\n", argv[3]);
+			return 1;
+		}
+
+		// FILE이 스냅샷이면 매핑하고, 아니면 입력 파일을 읽어 정렬
+		if ((names = _open_sorted( argv[2])) == NULL) return 1;
+
+		if ((cols = create_names_col( names)) == NULL)
+		{
+			fprintf( stderr, "out of memory\n");
+			destroy_names( names);
+			return 1;
+		}
+
+		if (!top_names( cols, k))
+		{
+			fprintf( stderr, "out of memory\n");
+			destroy_names_col( cols);
+			destroy_names( names);
+			return 1;
+		}
+
+		destroy_names_col( cols);
+		destroy_names( names);
+		return 0;
+	}
+
+	if (option == QUERY)
+	{
+		FILE *in = stdin;
+
+		// FILE이 스냅샷이면 매핑하고, 아니면 입력 파일을 읽어 정렬
+		if ((names = _open_sorted( argv[2])) == NULL) return 1;
+
+		if (argc == 4 && (in = fopen( argv[3], "r")) == NULL)
+		{
+			fprintf( stderr, "cannot open file : %s\n", argv[3]);
+			destroy_names( names);
+			return 1;
+		}
+
+		query_names( names, in);
+
+		if (in != stdin) fclose( in);
+		destroy_names( names);
+		return 0;
+	}
+
+	if (option == APPEND)
+	{
+		if (argc != 4)
+		{
+			fprintf( stderr, "Usage: %s -a SNAPSHOT FILE\n\n", argv[0]);
+			return 1;
+		}
+
+		if ((names = open_names( argv[2])) == NULL)
+		{
+			fprintf( stderr, "cannot open snapshot : %s\n", argv[2]);
+			return 1;
+		}
+
+		if ((fp = fopen( argv[3], "r")) == NULL)
+		{
+			fprintf( stderr, "cannot open file : %s\n", argv[3]);
+			destroy_names( names);
+			return 1;
+		}
+
+		// 새 연도의 입력 파일을 반영한 후 스냅샷을 다시 저장
+		if (!append_names( names, fp))
+		{
+			fprintf( stderr, "cannot read file : %s\n", argv[3]);
+			destroy_names( names);
+			fclose( fp);
+			return 1;
+		}
+		fclose( fp);
+
+		if (!save_names( names, argv[2]))
+		{
+			fprintf( stderr, "cannot write snapshot : %s\n", argv[2]);
+			destroy_names( names);
+			return 1;
+		}
+
+		destroy_names( names);
+		return 0;
+	}
+	
+	if (option == SNAPSHOT)
+	{
+		// 스냅샷 파일을 매핑 (정렬되어 있음)
+		if ((names = open_names( argv[2])) == NULL)
+		{
+			fprintf( stderr, "cannot open snapshot : %s\n", argv[2]);
+			return 1;
+		}
+	}
+	else
+	{
+		// 이름 구조체 초기화
+		names = create_names();
+
+		if ((fp = fopen( argv[2], "r")) == NULL) 
+		{
+			fprintf( stderr, "cannot open file : %s\n", argv[2]);
+			return 1;
+		}
+
+		if (option == LINEAR_SEARCH)
+		{
+			// 연도별 입력 파일(이름 정보)을 구조체에 저장
+			// 선형탐색 모드
+			ok = load_names_lsearch( fp, names);
+		}
+		else if (option == FINGERPRINT)
+		{
+			// 지문 선형탐색 모드
+			ok = load_names_fingerprint( fp, names);
+		}
+		else if (option == BINARY_SEARCH)
+		{
+			// 이진탐색 모드
+			ok = load_names_bsearch( fp, names);
+		}
+		else if (option == PARALLEL)
+		{
+			// 병렬 읽기 모드 (결과가 정렬되어 있음)
+			ok = load_names_parallel( fp, names);
+		}
+		else // (option == HASH_SEARCH || option == STATISTICS)
+		{
+			// 해시 인덱스 모드
+			ok = load_names_hash( fp, names);
+		}
+
+		fclose( fp);
+
+		if (!ok)
+		{
+			fprintf( stderr, "cannot read file : %s\n", argv[2]);
+			destroy_names( names);
+			return 1;
+		}
+	}
+
+	if (option == STATISTICS)
+	{
+		// 열 지향 구조체로 변환하여 연도별 집계 결과를 출력
+		tNamesCol *cols = create_names_col( names);
+
+		if (cols == NULL)
+		{
+			fprintf( stderr, "out of memory\n");
+			destroy_names( names);
+			return 1;
+		}
+
+		print_stats( cols);
+		destroy_names_col( cols);
+	}
+	else
+	{
+		// 정렬 (이름순 (이름이 같은 경우 성별순))
+		if (option != PARALLEL && option != SNAPSHOT)
+			sort_names( names);
+
+		// 이름 구조체를 화면에 출력
+		print_names( names);
+	}
+
+	// 정렬된 이름 구조체를 스냅샷 파일로 저장
+	if (argc == 4 && option != STATISTICS && !save_names( names, argv[3]))
+	{
+		fprintf( stderr, "cannot write snapshot : %s\n", argv[3]);
+	}
 
 	// 이름 구조체 해제
 	destroy_names( names);
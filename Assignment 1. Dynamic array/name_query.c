@@ -0,0 +1,178 @@
+#include <stdlib.h> // malloc, realloc, qsort
+#include <string.h> // memcpy, memset
+
+#include "name_out.h"
+#include "name_query.h"
+
+// internal function
+// 지연 시간 정렬을 위한 비교 함수
+static int _compare_double( const void *d1, const void *d2);
+
+////////////////////////////////////////////////////////////////////////////////
+static int _compare_double( const void *d1, const void *d2){
+	double a = *(const double *)d1, b = *(const double *)d2;
+
+	return (a > b) - (a < b);
+}
+
+int query_Read( FILE *in, tQuery *q){
+	char line[256];
+	char *p, *e;
+	int len;
+
+	if (fgets(line, sizeof(line), in) == NULL) return EOF;
+
+	for (p = line; *p == ' ' || *p == '\t'; p++);
+	for (e = p; *e && *e != ' ' && *e != '\t' && *e != '\r' && *e != '\n'; e++);
+	if (e == p) return 0;
+
+	len = (e - p < 19) ? (int)(e - p) : 19;
+	memcpy(q->name, p, len);
+	memset(q->name + len, 0, sizeof(q->name) - len);
+
+	for (p = e; *p == ' ' || *p == '\t'; p++);
+	if (*p == '\0' || *p == '\r' || *p == '\n') return 0;
+	q->sex = *p;
+
+	return 1;
+}
+
+int query_Gallop( const void *table, int from, int len, const void *key, int (*compare)( const void *table, int i, const void *key)){
+	int lo = from, hi = from, step = 1;
+
+	// 범위를 두 배씩 넓혀가며 key 이상인 위치를 찾음
+	while (hi < len && compare(table, hi, key) < 0){
+		lo = hi + 1;
+		hi += step;
+		step *= 2;
+	}
+	if (hi > len) hi = len;
+
+	// [lo, hi] 안에서 이진탐색
+	while (lo < hi){
+		int mid = (lo + hi) / 2;
+
+		if (compare(table, mid, key) < 0) lo = mid + 1;
+		else hi = mid;
+	}
+
+	return lo;
+}
+
+double query_Elapsed( const struct timespec *t0, const struct timespec *t1){
+	return (t1->tv_sec - t0->tv_sec) + (t1->tv_nsec - t0->tv_nsec) / 1e9;
+}
+
+void query_Run( FILE *in, void *table, const tQueryMethod *method, int num_method, void (*print)( WRITER *out, void *table, int idx)){
+	tQuery *query = (tQuery *)malloc(QUERY_BATCH * sizeof(tQuery));
+	int *found = (int *)malloc((size_t)num_method * QUERY_BATCH * sizeof(int)); // 방법별 결과
+	double *latency = NULL; // 배치별, 방법별 지연 시간 ([batch][method])
+	double *busy = (double *)calloc(num_method, sizeof(double));
+	int num_batch = 0, lat_cap = 0;
+	long long total = 0, hit = 0, diff = 0;
+	int eof = 0;
+	WRITER *out = out_Open(stdout);
+
+	if (query == NULL || found == NULL || busy == NULL || out == NULL){
+		fprintf(stderr, "query: out of memory\n");
+		eof = 1;
+	}
+
+	while (!eof){
+		int n = 0, ret;
+
+		// 배치 읽기
+		while (n < QUERY_BATCH && (ret = query_Read(in, &query[n])) != EOF){
+			if (ret == 1){
+				query[n].seq = n;
+				n++;
+			}
+		}
+		if (n < QUERY_BATCH) eof = 1;
+		if (n == 0) break;
+
+		if (num_batch == lat_cap){
+			double *tmp;
+
+			lat_cap = (lat_cap == 0) ? 1024 : lat_cap * 2;
+			tmp = (double *)realloc(latency, (size_t)lat_cap * num_method * sizeof(double));
+			if (tmp == NULL){
+				fprintf(stderr, "query: out of memory\n");
+				break;
+			}
+			latency = tmp;
+		}
+
+		fprintf(stderr, "batch %d: %d queries", num_batch + 1, n);
+
+		// 방법마다 배치 전체를 답함
+		for (int m = 0; m < num_method; m++){
+			struct timespec t0, t1;
+			double *lat = &latency[(size_t)num_batch * num_method + m];
+			int *res = found + (size_t)m * QUERY_BATCH;
+
+			clock_gettime(CLOCK_MONOTONIC, &t0);
+			method[m].answer(table, query, n, res);
+			clock_gettime(CLOCK_MONOTONIC, &t1);
+
+			*lat = query_Elapsed(&t0, &t1);
+			busy[m] += *lat;
+			fprintf(stderr, ", %s %.1f us", method[m].label, *lat * 1e6);
+		}
+		fprintf(stderr, "\n");
+
+		// 첫번째 방법과 결과가 다른 조회
+		for (int m = 1; m < num_method; m++){
+			int *res = found + (size_t)m * QUERY_BATCH;
+
+			for (int i = 0; i < n; i++){
+				if (res[i] == found[i]) continue;
+
+				if (diff++ < 10)
+					fprintf(stderr, "batch %d: %s %c: %s %d, %s %d\n", num_batch + 1, query[i].name, query[i].sex, method[0].label, found[i], method[m].label, res[i]);
+			}
+		}
+
+		// 입력 순서대로 결과 출력
+		for (int i = 0; i < n; i++){
+			if (found[i] < 0){
+				out_Str(out, query[i].name);
+				out_Char(out, '\t');
+				out_Char(out, query[i].sex);
+				out_Str(out, "\tnot found\n");
+				continue;
+			}
+
+			print(out, table, found[i]);
+			hit++;
+		}
+		out_Flush(out); // 배치마다 내보냄
+
+		total += n;
+		num_batch++;
+	}
+
+	if (num_batch > 0){
+		double *sorted = (double *)malloc(num_batch * sizeof(double));
+
+		fprintf(stderr, "%lld queries (%lld found) in %d batches\n", total, hit, num_batch);
+		if (diff > 0) fprintf(stderr, "%lld answers differ from %s\n", diff, method[0].label);
+
+		for (int m = 0; sorted != NULL && m < num_method; m++){
+			for (int b = 0; b < num_batch; b++) sorted[b] = latency[(size_t)b * num_method + m];
+			qsort(sorted, num_batch, sizeof(double), _compare_double);
+
+			fprintf(stderr, "%s: %.0f queries/s, batch latency (us): p50 %.1f, p90 %.1f, p99 %.1f, max %.1f\n",
+				method[m].label, total / busy[m],
+				sorted[(num_batch - 1) * 50 / 100] * 1e6, sorted[(num_batch - 1) * 90 / 100] * 1e6,
+				sorted[(num_batch - 1) * 99 / 100] * 1e6, sorted[num_batch - 1] * 1e6);
+		}
+		free(sorted);
+	}
+
+	if (out != NULL) out_Close(out);
+	free(latency);
+	free(busy);
+	free(found);
+	free(query);
+}
@@ -0,0 +1,44 @@
+// 조회 모드
+// "이름 성별" 형식의 조회를 QUERY_BATCH개씩 읽어, 배치마다 등록된 방법들로 답하고 시간을 잼
+// 첫번째 방법의 결과를 입력 순서대로 출력하고, 다른 방법의 결과가 다르면 stderr에 알림
+// 주의사항: name_out.h (WRITER)를 먼저 include해야 함
+
+#include <stdio.h> // FILE
+#include <time.h> // struct timespec
+
+#define QUERY_BATCH		4096	// 한 번에 처리하는 조회의 수
+
+// 조회 하나
+typedef struct {
+	char	name[20];	// 이름 (뒤의 빈 칸은 0으로 채움)
+	char	sex;		// 성별 M or F
+	int		seq;		// 배치 안에서의 입력 순서
+} tQuery;
+
+// 조회 방법
+// answer : 배치의 조회 query(n개, 입력 순서)에 답하여 found[i]에 i번째 조회의 인덱스(없으면 -1)를 저장
+typedef struct {
+	const char	*label;		// 통계에 출력할 이름
+	void		(*answer)( void *table, const tQuery *query, int n, int *found);
+} tQueryMethod;
+
+////////////////////////////////////////////////////////////////////////////////
+// function declarations
+
+// 조회 한 줄을 읽음 ("이름 성별", 19자보다 긴 이름은 잘림)
+// return	1 successful
+//			0 형식이 맞지 않는 줄
+//			EOF end of input
+int query_Read( FILE *in, tQuery *q);
+
+// 정렬된 배열(len개)의 from번째 이후에서 key 이상인 첫번째 위치 (galloping)
+// compare : table의 i번째 원소와 key의 비교 (strcmp와 같은 부호)
+int query_Gallop( const void *table, int from, int len, const void *key, int (*compare)( const void *table, int i, const void *key));
+
+// 시간 간격 (초)
+double query_Elapsed( const struct timespec *t0, const struct timespec *t1);
+
+// in의 조회를 끝까지 처리
+// 배치마다 method(num_method개)를 차례로 실행하고, 찾은 조회는 print로, 없는 조회는 "not found"를 출력
+// 배치별 지연 시간과 방법별 처리량, 지연 시간 분포(percentile)는 stderr에 출력
+void query_Run( FILE *in, void *table, const tQueryMethod *method, int num_method, void (*print)( WRITER *out, void *table, int idx));
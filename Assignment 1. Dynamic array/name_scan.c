@@ -0,0 +1,394 @@
+#include <stdlib.h> // malloc, realloc
+#include <string.h> // memcpy, memchr
+#include <pthread.h>
+#include <unistd.h> // sysconf
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+
+#include "name_scan.h"
+
+#define READ_CHUNK		(1 << 20)	// 읽기 스레드가 한 번에 읽는 크기
+#define PREFETCH_AHEAD	(64 << 20)	// 매핑된 입력에서 읽는 위치보다 앞서 미리 읽을 크기
+#define PREFETCH_WINDOW	(8 << 20)	// 미리 읽기를 한 번에 요청하는 크기
+
+// 스트림 입력의 읽기 스레드 상태
+// 읽기 스레드는 chunk[0], chunk[1]을 번갈아 채우고, scan_Next는 채워진 청크를 work로 가져감
+// 길이가 0인 청크는 입력의 끝
+typedef struct
+{
+	FILE			*fp;		// 입력 파일
+	pthread_t		tid;		// 읽기 스레드
+	int				threaded;	// 1: 읽기 스레드가 있음, 0: 스레드를 만들지 못해 scan_Next에서 직접 읽음
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;		// 청크가 채워지거나 비워질 때 알림
+	char			*chunk[2];	// 읽기 버퍼
+	size_t			len[2];		// 청크에 읽은 길이
+	int				full[2];	// 1: 채워져서 가져가기를 기다림
+	int				next;		// 다음에 가져갈 청크 번호
+	int				stop;		// 1: 읽기 중단 요청 (scan_Close)
+	int				done;		// 1: 입력의 끝까지 가져감
+	char			*work;		// 파싱하는 버퍼 (이전 청크의 마지막 줄 조각 + 새 청크)
+	size_t			work_size;	// work의 크기
+} tStream;
+
+// internal function
+// 매핑할 수 없는 입력을 읽을 읽기 스레드를 시작
+// return	1 successful
+//			0 if overflow
+static int _stream_Open( SCANNER *sc, FILE *fp);
+
+// internal function
+// 읽기 스레드를 멈추고 스트림에 할당된 메모리를 해제
+static void _stream_Close( tStream *st);
+
+// internal function
+// 읽기 스레드 (청크가 비워지기를 기다렸다가 다음 청크를 읽음)
+static void *_reader( void *arg);
+
+// internal function
+// p부터의 남은 입력(마지막 줄 조각) 뒤에 다음 청크를 이어 붙여 sc의 버퍼로 설정
+// return	1 successful
+//			0 end of input
+//			-1 if overflow or read error (청크는 읽기 스레드에 돌려줌)
+static int _refill( SCANNER *sc, const char *p);
+
+// internal function
+// 매핑된 입력에서 sc->ahead부터 PREFETCH_WINDOW만큼 미리 읽기를 요청
+static void _prefetch( SCANNER *sc);
+
+// internal function
+// p부터 10진수 정수를 읽고, 읽은 다음 위치를 반환
+static const char *_parseInt( const char *p, const char *end, int *value);
+
+////////////////////////////////////////////////////////////////////////////////
+static void *_reader( void *arg){
+	tStream *st = (tStream*)arg;
+	int i = 0;
+
+	while(1){
+		size_t n;
+		int stop;
+
+		pthread_mutex_lock(&st->lock);
+		while(st->full[i] && !st->stop) pthread_cond_wait(&st->cond, &st->lock);
+		stop = st->stop;
+		pthread_mutex_unlock(&st->lock);
+		if(stop) break;
+
+		// 다른 청크를 파싱하는 동안 읽음
+		n = fread(st->chunk[i], 1, READ_CHUNK, st->fp);
+
+		pthread_mutex_lock(&st->lock);
+		st->len[i] = n;
+		st->full[i] = 1;
+		pthread_cond_broadcast(&st->cond);
+		pthread_mutex_unlock(&st->lock);
+
+		if(n == 0) break; // 입력의 끝
+		i ^= 1;
+	}
+
+	return NULL;
+}
+
+static int _stream_Open( SCANNER *sc, FILE *fp){
+	tStream *st = (tStream*)calloc(1, sizeof(tStream));
+
+	if(st == NULL) return 0;
+
+	st->fp = fp;
+	st->chunk[0] = (char*)malloc(READ_CHUNK);
+	st->chunk[1] = (char*)malloc(READ_CHUNK);
+	st->work_size = 2 * READ_CHUNK;
+	st->work = (char*)malloc(st->work_size);
+	if(st->chunk[0] == NULL || st->chunk[1] == NULL || st->work == NULL){
+		free(st->chunk[0]);
+		free(st->chunk[1]);
+		free(st->work);
+		free(st);
+		return 0;
+	}
+
+	pthread_mutex_init(&st->lock, NULL);
+	pthread_cond_init(&st->cond, NULL);
+	st->threaded = (pthread_create(&st->tid, NULL, _reader, st) == 0);
+
+	sc->buf = sc->cur = sc->end = st->work;
+	sc->size = 0;
+	sc->mapped = 0;
+	sc->ahead = NULL;
+	sc->stream = st;
+
+	return 1;
+}
+
+static void _stream_Close( tStream *st){
+	if(st->threaded){
+		pthread_mutex_lock(&st->lock);
+		st->stop = 1;
+		pthread_cond_broadcast(&st->cond);
+		pthread_mutex_unlock(&st->lock);
+
+		pthread_join(st->tid, NULL);
+	}
+
+	pthread_mutex_destroy(&st->lock);
+	pthread_cond_destroy(&st->cond);
+	free(st->chunk[0]);
+	free(st->chunk[1]);
+	free(st->work);
+	free(st);
+}
+
+static int _refill( SCANNER *sc, const char *p){
+	tStream *st = (tStream*)sc->stream;
+	size_t rest = sc->end - p;
+	size_t len;
+	int i = st->next;
+
+	if(st->done) return 0;
+
+	if(!st->threaded){ // 스레드 없이 직접 읽음
+		st->len[i] = fread(st->chunk[i], 1, READ_CHUNK, st->fp);
+		st->full[i] = 1;
+	}
+
+	pthread_mutex_lock(&st->lock);
+	while(!st->full[i]) pthread_cond_wait(&st->cond, &st->lock);
+	len = st->len[i]; // 청크를 돌려준 후에는 읽기 스레드가 바꿈
+	pthread_mutex_unlock(&st->lock);
+
+	if(len == 0){
+		st->done = 1;
+		return ferror(st->fp) ? -1 : 0;
+	}
+
+	// 남은 줄 조각을 앞으로 옮기고 새 청크를 이어 붙임
+	if(rest + len > st->work_size){
+		size_t off = p - st->work;
+		size_t size = st->work_size;
+		char *tmp;
+
+		while(rest + len > size) size *= 2;
+		tmp = (char*)realloc(st->work, size);
+		if(tmp == NULL){
+			// overflow: 청크를 돌려주고 더 이상 읽지 않음
+			pthread_mutex_lock(&st->lock);
+			st->full[i] = 0;
+			pthread_cond_broadcast(&st->cond);
+			pthread_mutex_unlock(&st->lock);
+			st->done = 1;
+			return -1;
+		}
+		st->work = tmp;
+		st->work_size = size;
+		p = tmp + off;
+	}
+	memmove(st->work, p, rest);
+	memcpy(st->work + rest, st->chunk[i], len);
+
+	// 청크를 돌려주어 읽기 스레드가 다시 채우게 함
+	pthread_mutex_lock(&st->lock);
+	st->full[i] = 0;
+	pthread_cond_broadcast(&st->cond);
+	pthread_mutex_unlock(&st->lock);
+	st->next = i ^ 1;
+
+	sc->buf = sc->cur = st->work;
+	sc->end = st->work + rest + len;
+
+	return 1;
+}
+
+static void _prefetch( SCANNER *sc){
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	size_t len = sc->end - sc->ahead;
+	const char *from = (const char*)((size_t)sc->ahead & ~(page - 1)); // 페이지 경계로 내림
+
+	if(len > PREFETCH_WINDOW) len = PREFETCH_WINDOW;
+
+	madvise((void*)from, sc->ahead + len - from, MADV_WILLNEED);
+	sc->ahead += len;
+}
+
+static const char *_parseInt( const char *p, const char *end, int *value){
+	int v = 0, neg = 0;
+
+	if(p < end && *p == '-'){
+		neg = 1;
+		p++;
+	}
+
+	while(p < end && (unsigned)(*p - '0') < 10){
+		v = v * 10 + (*p - '0');
+		p++;
+	}
+
+	*value = neg ? -v : v;
+	return p;
+}
+
+SCANNER *scan_Open( FILE *fp){
+	SCANNER *sc = (SCANNER*)malloc(sizeof(SCANNER));
+	struct stat st;
+	long offset = ftell(fp);
+
+	if(sc == NULL) return NULL;
+
+	if(offset < 0) offset = 0;
+
+	if(fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0){
+		void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+
+		if(map != MAP_FAILED){
+			madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+			sc->buf = (const char*)map;
+			sc->size = st.st_size;
+			sc->mapped = 1;
+			sc->cur = sc->buf + ((offset < st.st_size) ? offset : st.st_size);
+			sc->end = sc->buf + st.st_size;
+			sc->ahead = sc->cur;
+			sc->stream = NULL;
+			sc->error = 0;
+
+			return sc;
+		}
+	}
+
+	// 매핑할 수 없는 입력 (파이프, 빈 파일 등)
+	if(_stream_Open(sc, fp) == 0){
+		free(sc);
+		return NULL;
+	}
+	sc->error = 0;
+
+	return sc;
+}
+
+void scan_Close( SCANNER *sc){
+	if(sc->stream) _stream_Close((tStream*)sc->stream);
+	else if(sc->mapped) munmap((void*)sc->buf, sc->size);
+	else free((void*)sc->buf);
+
+	free(sc);
+}
+
+int scan_Next( SCANNER *sc, tRecord *rec){
+	const char *p = sc->cur;
+	const char *end = sc->end;
+
+	// 매핑된 입력은 읽는 위치보다 PREFETCH_AHEAD 앞까지 미리 읽기를 요청
+	if(sc->ahead != NULL && sc->ahead < end && sc->ahead - p < PREFETCH_AHEAD) _prefetch(sc);
+
+	while(1){
+		const char *q;
+		const char *eol;
+
+		// 줄 앞의 공백과 빈 줄은 건너뜀
+		while(p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+
+		eol = (p < end) ? (const char*)memchr(p, '\n', end - p) : NULL;
+
+		// 스트림 입력에서 마지막 줄이 버퍼에 다 들어 있지 않으면 다음 청크를 이어 붙임
+		if(eol == NULL && sc->stream != NULL){
+			int ret = _refill(sc, p);
+
+			if(ret > 0){
+				p = sc->cur;
+				end = sc->end;
+				continue;
+			}
+
+			// 읽기 실패: 남은 줄 조각은 버리고 끝냄
+			if(ret < 0){
+				sc->error = 1;
+				sc->cur = end;
+				return 0;
+			}
+		}
+
+		if(p == end) break;
+		if(eol == NULL) eol = end;
+
+		// 연도
+		q = _parseInt(p, eol, &rec->year);
+		if(q == p) goto skip;
+		p = q;
+
+		// 이름
+		while(p < eol && (*p == ' ' || *p == '\t')) p++;
+		q = p;
+		while(q < eol && *q != ' ' && *q != '\t' && *q != '\r') q++;
+		if(q == p) goto skip;
+		rec->name = p;
+		rec->name_len = (int)(q - p);
+		p = q;
+
+		// 성별
+		while(p < eol && (*p == ' ' || *p == '\t')) p++;
+		if(p == eol) goto skip;
+		rec->sex = *p++;
+
+		// 빈도
+		while(p < eol && (*p == ' ' || *p == '\t')) p++;
+		q = _parseInt(p, eol, &rec->freq);
+		if(q == p) goto skip;
+
+		sc->cur = (eol < end) ? eol + 1 : end;
+		return 1;
+
+	skip: // 형식이 맞지 않는 줄
+		p = (eol < end) ? eol + 1 : end;
+	}
+
+	sc->cur = end;
+	return 0;
+}
+
+void scan_Slice( const SCANNER *sc, int k, int n, SCANNER *part){
+	size_t len = sc->end - sc->cur;
+
+	// 스트림 입력은 나눌 수 없음 (0번째 구간이 전체)
+	if(sc->stream != NULL){
+		*part = *sc;
+		part->size = 0;
+		part->error = 0;
+		if(k > 0){
+			part->buf = part->cur = sc->end;
+			part->stream = NULL;
+		}
+		return;
+	}
+
+	const char *from = sc->cur + len / n * k;
+	const char *to = (k == n - 1) ? sc->end : sc->cur + len / n * (k + 1);
+
+	// 구간의 경계를 다음 줄의 시작으로 맞춤
+	// (경계가 줄의 시작이면 그대로, 아니면 그 줄은 앞 구간에 포함)
+	if(from > sc->cur && from[-1] != '\n'){
+		from = (const char*)memchr(from, '\n', sc->end - from);
+		from = (from == NULL) ? sc->end : from + 1;
+	}
+	if(k < n - 1 && to > sc->cur && to[-1] != '\n'){
+		to = (const char*)memchr(to, '\n', sc->end - to);
+		to = (to == NULL) ? sc->end : to + 1;
+	}
+	if(to < from) to = from;
+
+	part->buf = sc->buf;
+	part->cur = from;
+	part->end = to;
+	part->size = 0;
+	part->mapped = 0;
+	part->ahead = (sc->ahead != NULL) ? from : NULL;
+	part->stream = NULL;
+	part->error = 0;
+}
+
+void scan_Copy( const tRecord *rec, char *dst, int size){
+	int len = (rec->name_len < size) ? rec->name_len : size - 1;
+
+	memcpy(dst, rec->name, len);
+	memset(dst + len, 0, size - len); // 남은 자리는 0으로 채움 (고정 길이 비교용)
+}
@@ -1,22 +1,103 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h> // offsetof
+#include <unistd.h> // close
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <fcntl.h> // open
+#include <stdint.h> // uint32_t, uint64_t
 
-#define MAX_YEAR_DURATION	10	// 기간
+#include "name_scan.h"
+#include "name_out.h"
+#include "name_query.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define BATCH_MERGE	1 // 1: 배치 정렬-병합으로 읽기, 0: tiered vector로 읽기 (used in load_names function)
+
+#define BLOCK_SIZE			256	// tiered vector의 블록 하나에 저장하는 이름의 수
+#define BATCH_SIZE			65536	// 배치 하나에 모으는 최대 행의 수
+
+#define SNAPSHOT_MAGIC		"NAMESNAP"	// 스냅샷 파일 식별자 (8 bytes)
+#define SNAPSHOT_VERSION	2			// 스냅샷 파일 형식 버전 (2: 이름 뒤가 0으로 채워짐)
 
 // 구조체 선언
+// 연도별 빈도는 구조체 뒤에 연도의 수(num_year)만큼 이어서 저장됨
+// 배열 원소의 크기가 rec_size이므로 배열은 NAME_AT, BLOCK_AT으로 접근해야 함
 typedef struct {
 	char	name[20];		// 이름
 	char	sex;			// 성별 M or F
-	int		freq[MAX_YEAR_DURATION]; // 연도별 빈도
+	int		freq[];			// 연도별 빈도 (num_year개)
 } tName;
 
 typedef struct {
 	int		len;		// 배열에 저장된 이름의 수
 	int		capacity;	// 배열의 용량 (배열에 저장 가능한 이름의 수)
 	tName	*data;		// 이름 배열의 포인터
+	size_t	map_size;	// 스냅샷을 mmap으로 연 경우 매핑 크기 (0이면 malloc으로 할당된 배열)
+	int		start_year;	// 시작 연도
+	int		num_year;	// 연도의 수 (0이면 아직 읽은 연도가 없음)
+	int		rec_size;	// 이름 구조체 하나의 크기 (REC_SIZE(num_year))
 } tNames;
 
+// 연도의 수가 num_year인 이름 구조체의 크기
+#define REC_SIZE(num_year)	(offsetof(tName, freq) + (size_t)(num_year) * sizeof(int))
+
+// 이름 구조체 배열의 i번째 이름
+#define NAME_AT(names, i)	((tName *)((char *)(names)->data + (size_t)(i) * (names)->rec_size))
+
+// 스냅샷 파일 헤더 (64 bytes)
+// 헤더 다음에 정렬된 이름 구조체 배열(count개)이 그대로 저장됨
+typedef struct {
+	char	magic[8];		// SNAPSHOT_MAGIC
+	int		version;		// SNAPSHOT_VERSION
+	int		count;			// 이름의 수
+	int		start_year;		// 시작 연도
+	int		num_year;		// 연도의 수 (저장된 연도 범위: start_year ~ start_year + num_year - 1)
+	int		rec_size;		// 이름 구조체의 크기
+	int		reserved[9];
+} tSnapHeader;
+
+// tiered vector의 블록 (정렬된 이름 배열)
+typedef struct {
+	int		len;		// 블록에 저장된 이름의 수
+	tName	*data;		// BLOCK_SIZE 크기의 이름 배열
+} tBlock;
+
+// 정렬 리스트 (tiered vector)
+// 이름을 BLOCK_SIZE 크기의 블록들에 나누어 저장하여, 삽입 시 한 블록 안에서만 memmove
+// 블록이 가득 차면 절반씩 두 블록으로 나눔
+typedef struct {
+	int		len;		// 저장된 이름의 수
+	int		num_block;	// 블록의 수
+	int		capacity;	// 블록 배열의 용량
+	tBlock	*block;		// 블록 배열
+	int		start_year;	// 시작 연도
+	int		num_year;	// 연도의 수
+	int		rec_size;	// 이름 구조체 하나의 크기
+} tTiered;
+
+// 블록 b의 i번째 이름
+#define BLOCK_AT(list, b, i)	((tName *)((char *)(b)->data + (size_t)(i) * (list)->rec_size))
+
+// 배치에 모아둔 입력 행
+typedef struct {
+	char	name[20];	// 이름
+	char	sex;		// 성별 M or F
+	int		year;		// 연도
+	int		freq;		// 빈도
+	int		seq;		// 배치 안에서의 입력 순서
+} tRow;
+
+// 조회 모드의 조회 대상
+typedef struct {
+	tNames	*names;		// 정렬된 이름 구조체 배열
+	tQuery	*sorted;	// 정렬한 배치 (QUERY_BATCH개)
+} tQueryTable;
+
 ////////////////////////////////////////////////////////////////////////////////
 // 함수 원형 선언
 
@@ -25,19 +106,106 @@ typedef struct {
 // 새로 등장한 이름은 구조체에 추가
 // 주의사항: 동일 이름이 남/여 각각 사용될 수 있으므로, 이름과 성별을 구별해야 함
 // 주의사항: 정렬 리스트(ordered list)를 유지해야 함 (qsort 함수 사용하지 않음)
-// 이미 등장한 이름인지 검사하기 위해 bsearch 함수를 사용
-// 새로운 이름을 저장할 메모리 공간을 확보하기 위해 memmove 함수를 이용하여 메모리에 저장된 내용을 복사
+// BATCH_MERGE에 따라 load_names_batch 또는 load_names_tiered를 사용
 // names->capacity는 1000으로부터 시작하여 1000씩 증가 (1000, 2000, 3000, ...)
-// start_year : 시작 연도 (2009)
-void load_names( FILE *fp, int start_year, tNames *names);
+// 연도 범위는 입력에서 결정 (입력에 등장한 연도 범위)
+// return	1 successful
+//			0 입력을 끝까지 읽지 못한 경우 (메모리 부족, 읽기 오류)
+int load_names( FILE *fp, tNames *names);
+
+// 배치 정렬-병합 버전
+// 한 연도(최대 BATCH_SIZE 행)의 입력을 배치로 모아 한 번 정렬한 후,
+// 정렬된 이름 구조체 배열과 한 번의 선형 병합으로 합침
+// 이미 존재하는 이름은 빈도를 갱신하고, 새로운 이름은 순서에 맞게 끼워 넣음
+int load_names_batch( FILE *fp, tNames *names);
+
+// tiered vector 버전
+// 정렬 리스트는 tiered vector로 유지하고, 블록 안의 탐색은 binary_search 함수를 사용
+// 새로운 이름을 저장할 메모리 공간은 해당 블록 안에서만 memmove 함수로 확보
+// 다 읽은 후 정렬 리스트를 이름 구조체 배열로 복사
+int load_names_tiered( FILE *fp, tNames *names);
+
+// 배치를 정렬된 이름 구조체 배열에 병합
+// batch는 compare_row 기준으로 정렬되어 있어야 함
+// 배치의 연도가 연도 범위를 벗어나면 결과 배열의 연도 범위를 넓힘
+void merge_batch( tNames *names, tRow *batch, int len);
+
+// 연도 범위를 start_year ~ start_year + num_year - 1로 바꾸고 모든 행을 새 크기로 다시 배치
+// 범위 밖의 연도 빈도는 버려지며, 새로 생긴 연도의 빈도는 0
+void resize_years( tNames *names, int start_year, int num_year);
+
+// 연도 범위를 빈도가 0이 아닌 연도가 있는 범위로 줄임
+void fit_years( tNames *names);
+
+// 정렬된 이름 구조체 배열을 스냅샷 파일로 저장
+// 임시 파일에 쓴 후 이름을 바꾸므로, 기존 파일은 항상 온전한 상태로 남음
+// return	1 successful
+//			0 if failed
+int save_names( tNames *names, const char *path);
+
+// 스냅샷 파일을 읽기 전용으로 mmap하여 이름 구조체를 생성 (파싱, 복사 없음)
+// 반환된 이름 구조체의 배열은 수정할 수 없으며, destroy_names로 해제
+// 연도 범위는 스냅샷 헤더의 start_year, num_year
+// return	이름 구조체 포인터
+//			NULL if failed (파일이 없거나 형식이 맞지 않는 경우)
+tNames *open_names( const char *path);
+
+// 조회 모드
+// in에서 "이름 성별" 형식의 조회를 QUERY_BATCH개씩 읽어, 배치마다 정렬한 후
+// 정렬된 이름 구조체 배열과 한 번의 병합 순회(galloping)로 답함
+// 조회 결과(연도별 빈도)는 입력 순서대로 출력하고, 없는 이름은 "not found"를 출력
+// 배치별 처리량과 지연 시간, 전체 지연 시간 분포(percentile)는 stderr에 출력
+void query_names( tNames *names, FILE *in);
+
+// 구조체 배열을 화면에 출력 (연도 범위의 모든 연도)
+void print_names( tNames *names);
+
+// 빈 정렬 리스트(tiered vector)를 생성
+// return : 정렬 리스트 포인터
+tTiered *create_tiered(void);
+
+// 정렬 리스트에 할당된 메모리를 해제
+void destroy_tiered( tTiered *list);
+
+// 정렬 리스트에서 key를 탐색
+// blk, idx : key가 발견되는 경우, key가 저장된 블록과 블록 안의 인덱스
+//			key가 발견되지 않는 경우, key가 삽입되어야 할 블록과 블록 안의 인덱스
+// return value: key가 발견되는 경우, 저장된 이름 구조체의 포인터
+//				key가 발견되지 않는 경우, NULL
+tName *tiered_search( tTiered *list, const tName *key, int *blk, int *idx);
+
+// 정렬 리스트의 blk번째 블록의 idx 위치에 이름을 삽입 (tiered_search의 결과 위치)
+// data는 list->rec_size 크기의 이름 구조체
+// return value: 삽입된 이름 구조체의 포인터
+tName *tiered_insert( tTiered *list, int blk, int idx, const tName *data);
 
-// 구조체 배열을 화면에 출력
-void print_names( tNames *names, int num_year);
+// 연도 year의 인덱스 (year - list->start_year)
+// year가 연도 범위를 벗어나면 범위를 (최소한 두 배로) 넓히고 모든 블록을 새 크기로 다시 배치
+// 주의사항: 범위를 넓히면 이전에 얻은 이름 구조체의 포인터는 무효
+int tiered_year( tTiered *list, int year);
+
+// 정렬 리스트의 내용을 이름 구조체 배열에 순서대로 복사
+void tiered_copy( tTiered *list, tNames *names);
 
 // bsearch를 위한 비교 함수
 // 정렬 기준 : 이름(1순위), 성별(2순위)
 int compare( const void *n1, const void *n2);
 
+// 배치 정렬을 위한 비교 함수
+// 정렬 기준 : 이름(1순위), 성별(2순위), 입력 순서(3순위)
+int compare_row( const void *r1, const void *r2);
+
+// 조회 정렬을 위한 비교 함수 (이름, 성별 순)
+int compare_query( const void *q1, const void *q2);
+
+// 0으로 채워진 20 bytes 이름 두 개를 비교 (strcmp와 같은 순서)
+// 앞 16 bytes는 SSE2 한 번, 나머지 4 bytes는 byte-swap한 정수 하나로 비교
+// return	음수, 0, 양수 (strcmp와 같은 부호)
+int compare_name( const char *a, const char *b);
+
+// 이름을 name[20]에 복사하고 남은 뒤를 0으로 채움 (19자보다 긴 이름은 잘림)
+void copy_name( char *dst, const char *src);
+
 // 이진탐색 함수
 // return value: key가 발견되는 경우, 배열의 인덱스
 //				key가 발견되지 않는 경우, key가 삽입되어야 할 배열의 인덱스
@@ -46,102 +214,494 @@ int binary_search( const void *key, const void *base, size_t nmemb, size_t size,
 ////////////////////////////////////////////////////////////////////////////////
 // 함수 정의
 
-void load_names( FILE *fp, int start_year, tNames *names){
+int load_names( FILE *fp, tNames *names){
+#if BATCH_MERGE
+	return load_names_batch( fp, names);
+#else
+	return load_names_tiered( fp, names);
+#endif
+}
+
+int load_names_batch( FILE *fp, tNames *names){
 	
-	char tmp_name[20], tmp_sex;
-	int tmp_year, tmp_freq;
-	int idx = 0;
-	tName* find;
-	tName* key;
+	tRow *batch = (tRow *)malloc(BATCH_SIZE * sizeof(tRow));
+	int len = 0;
+	int pre_year = -1;
+	int ok;
+	SCANNER *sc = scan_Open( fp);
+	tRecord rec;
 	
-	while(!feof( fp)){
-		fscanf( fp, "%d %s %c %d\n", &tmp_year, tmp_name, &tmp_sex, &tmp_freq);
+	if( sc == NULL){
+		free(batch);
+		return 0;
+	}
+	
+	while( scan_Next( sc, &rec)){
 		
-		if( names->len >= names->capacity - 10){
-			// capacity 가 부족하면 +1000
-			names->capacity += 1000;
-			names->data = (tName *)realloc(names->data, names->capacity * sizeof(tName));
+		// 연도가 바뀌거나 배치가 가득 차면 정렬 후 병합
+		if( len == BATCH_SIZE || (len > 0 && rec.year != pre_year)){
+			qsort(batch, len, sizeof(tRow), compare_row);
+			merge_batch( names, batch, len);
+			len = 0;
 		}
+		pre_year = rec.year;
 		
-		if( names->len == 0){
-			// 두번째 값을 불러올 때부터 이진탐색을 하기 위해 첫번째 값을 우선 배열에 삽입
-			strcpy(names->data[0].name, tmp_name);
-			names->data[0].sex = tmp_sex;
-			names->data[0].freq[tmp_year - start_year] = tmp_freq;
-			names->len ++;
-			continue;
+		scan_Copy( &rec, batch[len].name, sizeof(batch[len].name));
+		batch[len].sex = rec.sex;
+		batch[len].year = rec.year;
+		batch[len].freq = rec.freq;
+		batch[len].seq = len;
+		len ++;
+	}
+	
+	if( len > 0){
+		qsort(batch, len, sizeof(tRow), compare_row);
+		merge_batch( names, batch, len);
+	}
+	
+	ok = !sc->error;
+	free(batch);
+	scan_Close( sc);
+	
+	return ok;
+}
+
+void merge_batch( tNames *names, tRow *batch, int len){
+	tNames out;
+	int first, last;
+	int i = 0, j = 0, k = 0;
+	
+	// 결과 배열의 연도 범위 (기존 범위와 배치의 연도를 모두 포함)
+	first = (names->num_year > 0) ? names->start_year : batch[0].year;
+	last = (names->num_year > 0) ? names->start_year + names->num_year - 1 : batch[0].year;
+	for( int r = 0; r < len; r++){
+		if( batch[r].year < first) first = batch[r].year;
+		if( batch[r].year > last) last = batch[r].year;
+	}
+	
+	out.start_year = first;
+	out.num_year = last - first + 1;
+	out.rec_size = REC_SIZE(out.num_year);
+	
+	// 결과 배열의 용량 확보 (1000 단위)
+	out.capacity = names->capacity;
+	if( out.capacity < names->len + len)
+		out.capacity = (names->len + len + 999) / 1000 * 1000;
+	out.data = (tName *)malloc((size_t)out.capacity * out.rec_size);
+	
+	while( i < names->len || j < len){
+		tName *o = NAME_AT(&out, k);
+		int cmp;
+		
+		if( j == len) cmp = -1;
+		else if( i == names->len) cmp = 1;
+		else{
+			cmp = compare_name(NAME_AT(names, i)->name, batch[j].name);
+			if( cmp == 0) cmp = NAME_AT(names, i)->sex - batch[j].sex;
 		}
 		
-		key = (tName*)malloc(sizeof(tName));
-		strcpy(key->name, tmp_name);
-		key->sex = tmp_sex;
-		key->freq[tmp_year - start_year] = tmp_freq;
+		memset(o, 0, out.rec_size);
 		
-		// key의 주소를 불러와서 오류 발생(&key)
-		find = (tName*)bsearch(key, names->data, names->len, sizeof(tName), compare);
+		if( cmp <= 0){ // 기존 이름 (연도 인덱스를 새 범위에 맞춰 복사)
+			tName *p = NAME_AT(names, i++);
+			
+			memcpy(o, p, offsetof(tName, freq));
+			memcpy(o->freq + (names->start_year - first), p->freq, names->num_year * sizeof(int));
+		}
+		else{ // 같은 이름이 없는 경우
+			memcpy(o->name, batch[j].name, sizeof(o->name));
+			o->sex = batch[j].sex;
+		}
 		
-		if( find == NULL){ // 같은 이름이 없는 경우
+		k ++;
+		if( cmp < 0) continue; // 기존 이름만 있는 경우
+		
+		// 배치 안의 같은 이름(성별)의 행을 입력 순서대로 반영
+		do{
+			o->freq[batch[j].year - first] = batch[j].freq;
+			j ++;
+		} while( j < len && batch[j].sex == o->sex && compare_name(batch[j].name, o->name) == 0);
+	}
+	
+	free(names->data);
+	names->data = out.data;
+	names->len = k;
+	names->capacity = out.capacity;
+	names->start_year = out.start_year;
+	names->num_year = out.num_year;
+	names->rec_size = out.rec_size;
+}
+
+void resize_years( tNames *names, int start_year, int num_year){
+	int rec_size = REC_SIZE(num_year);
+	char *data = (char *)malloc((size_t)names->capacity * rec_size);
+	// 이전 범위와 새 범위가 겹치는 연도 [lo, hi)
+	int lo = (start_year > names->start_year) ? start_year : names->start_year;
+	int hi = (start_year + num_year < names->start_year + names->num_year) ? start_year + num_year : names->start_year + names->num_year;
+	
+	for( int i = 0; i < names->len; i++){
+		tName *src = NAME_AT(names, i);
+		tName *dst = (tName *)(data + (size_t)i * rec_size);
 		
-			for (int i = 0; i < 10; i++){
-                	names->data[names->len].freq[i] = 0;
-           	}
+		memcpy(dst, src, offsetof(tName, freq));
+		memset(dst->freq, 0, num_year * sizeof(int));
+		if( lo < hi) memcpy(dst->freq + (lo - start_year), src->freq + (lo - names->start_year), (hi - lo) * sizeof(int));
+	}
 	
-			// 인덱스 값 찾기
-			// key의 주소를 불러와서 오류 발생(&key)
-			idx = binary_search(key, names->data, names->len, sizeof(tName), compare);
-			
-			// void* memmove(void* dest, const void* source, size_t num)
-			// dest : 데이터가 복사될 곳을 가리키는 포인터, source : 복사할 데이터가 있는 위치 포인터, num: 복사할 바이트 수
-			memmove(&(names->data[idx+1]), &(names->data[idx]), ((names->len) - idx) * sizeof(tName));
+	if( names->map_size > 0) munmap((char *)names->data - sizeof(tSnapHeader), names->map_size);
+	else free(names->data);
+	
+	names->data = (tName *)data;
+	names->map_size = 0;
+	names->start_year = start_year;
+	names->num_year = num_year;
+	names->rec_size = rec_size;
+}
 
-			// void* memset(void* ptr, int value, size_t num)
-			// ptr : 세팅하고자 하는 메모리의 시작 주소, value : 메모리에 세팅하고자 하는 값, num : 길이
-			memset(&(names->data[idx]), 0, sizeof(tName));
-			
-			strcpy(names->data[idx].name, tmp_name);
-			names->data[idx].sex = tmp_sex;
-			names->data[idx].freq[tmp_year - start_year] = tmp_freq;
-			names->len ++;
-			
+void fit_years( tNames *names){
+	int first = names->num_year, last = -1; // 빈도가 0이 아닌 첫번째, 마지막 연도 인덱스
+	
+	for( int i = 0; i < names->len; i++){
+		tName *p = NAME_AT(names, i);
+		
+		for( int y = 0; y < first; y++)
+			if( p->freq[y] != 0){
+				first = y;
+				break;
+			}
+		for( int y = names->num_year - 1; y > last; y--)
+			if( p->freq[y] != 0){
+				last = y;
+				break;
+			}
+	}
+	
+	if( first > last) return; // 빈도가 있는 연도가 없음
+	if( first == 0 && last == names->num_year - 1) return;
+	
+	resize_years( names, names->start_year + first, last - first + 1);
+}
+
+int load_names_tiered( FILE *fp, tNames *names){
+	
+	tName *key = NULL; // list->rec_size 크기의 삽입할 이름 구조체
+	tName *tmp;
+	int key_size = 0; // key의 할당 크기
+	int ok = 1;
+	tName* find;
+	int blk, idx, y;
+	tTiered *list;
+	SCANNER *sc = scan_Open( fp);
+	tRecord rec;
+	
+	if( sc == NULL) return 0;
+	
+	list = create_tiered();
+	
+	while( scan_Next( sc, &rec)){
+		y = tiered_year( list, rec.year);
+		
+		// 연도 범위가 넓어진 경우에만 다시 할당
+		if( key_size != list->rec_size){
+			tmp = (tName *)realloc(key, list->rec_size);
+			if( tmp == NULL){
+				ok = 0;
+				break;
+			}
+			key = tmp;
+			key_size = list->rec_size;
 		}
 		
-		else{ // 이름과 성별이 모두 같은 경우
-			find->freq[tmp_year - start_year] = key->freq[tmp_year  - start_year];
+		scan_Copy( &rec, key->name, sizeof(key->name));
+		key->sex = rec.sex;
+		
+		find = tiered_search( list, key, &blk, &idx);
+		
+		if( find == NULL){ // 같은 이름이 없는 경우
+			memset( key->freq, 0, list->num_year * sizeof(int));
+			key->freq[y] = rec.freq;
+			tiered_insert( list, blk, idx, key);
 		}
 		
-		free(key);
+		else{ // 이름과 성별이 모두 같은 경우
+			find->freq[y] = rec.freq;
+		}
 	}
+	
+	// 정렬 리스트를 이름 구조체 배열로 복사
+	tiered_copy( list, names);
+	fit_years( names);
+	
+	if( sc->error) ok = 0;
+	free(key);
+	destroy_tiered( list);
+	scan_Close( sc);
+	
+	return ok;
+}
+
+tTiered *create_tiered(void){
+	tTiered *list = (tTiered *)malloc(sizeof(tTiered));
+	
+	list->len = 0;
+	list->num_block = 0;
+	list->capacity = 16;
+	list->block = (tBlock *)malloc(list->capacity * sizeof(tBlock));
+	list->start_year = 0;
+	list->num_year = 0;
+	list->rec_size = REC_SIZE(0);
+	
+	return list;
 }
 
-void print_names( tNames *names, int num_year){
-	int i , j;
+void destroy_tiered( tTiered *list){
+	for(int i = 0; i < list->num_block; i++)
+		free(list->block[i].data);
+	
+	free(list->block);
+	free(list);
+}
+
+tName *tiered_search( tTiered *list, const tName *key, int *blk, int *idx){
+	int l = 0, r = list->num_block - 1;
+	int mid;
+	tBlock *b;
+	
+	// key보다 크거나 같은 이름이 마지막에 저장된 첫번째 블록을 찾음
+	while( l <= r){
+		mid = (l + r) / 2;
+		b = &list->block[mid];
+		if( compare(key, BLOCK_AT(list, b, b->len - 1)) > 0) l = mid + 1;
+		else r = mid - 1;
+	}
+	
+	// 모든 이름보다 큰 경우 마지막 블록의 끝에 삽입
+	if( l == list->num_block){
+		*blk = (l > 0) ? l - 1 : 0;
+		*idx = (l > 0) ? list->block[l - 1].len : 0;
+		return NULL;
+	}
+	
+	b = &list->block[l];
+	*blk = l;
+	*idx = binary_search(key, b->data, b->len, list->rec_size, compare);
+	
+	if( compare(key, BLOCK_AT(list, b, *idx)) == 0) return BLOCK_AT(list, b, *idx);
+	return NULL;
+}
+
+tName *tiered_insert( tTiered *list, int blk, int idx, const tName *data){
+	tBlock *b;
+	
+	if( list->num_block == 0){ // 첫번째 블록
+		list->block[0].len = 0;
+		list->block[0].data = (tName *)malloc(BLOCK_SIZE * list->rec_size);
+		list->num_block = 1;
+	}
+	
+	b = &list->block[blk];
+	
+	if( b->len == BLOCK_SIZE){
+		// 블록이 가득 찬 경우 뒤쪽 절반을 새 블록으로 옮김
+		if( list->num_block == list->capacity){
+			list->capacity *= 2;
+			list->block = (tBlock *)realloc(list->block, list->capacity * sizeof(tBlock));
+		}
+		
+		memmove(&(list->block[blk+2]), &(list->block[blk+1]), (list->num_block - blk - 1) * sizeof(tBlock));
+		list->num_block ++;
+		
+		b = &list->block[blk];
+		b[1].len = BLOCK_SIZE / 2;
+		b[1].data = (tName *)malloc(BLOCK_SIZE * list->rec_size);
+		memcpy(b[1].data, BLOCK_AT(list, b, BLOCK_SIZE / 2), (BLOCK_SIZE / 2) * list->rec_size);
+		b->len = BLOCK_SIZE / 2;
+		
+		if( idx > BLOCK_SIZE / 2){
+			b ++;
+			idx -= BLOCK_SIZE / 2;
+		}
+	}
+	
+	// 블록 안에서만 memmove
+	memmove(BLOCK_AT(list, b, idx+1), BLOCK_AT(list, b, idx), (b->len - idx) * list->rec_size);
+	memcpy(BLOCK_AT(list, b, idx), data, list->rec_size);
+	b->len ++;
+	list->len ++;
+	
+	return BLOCK_AT(list, b, idx);
+}
 
-	for(i = 0; i < names->len; i++){
-		printf("%s	%c", names->data[i].name, names->data[i].sex);
+int tiered_year( tTiered *list, int year){
+	int first = list->start_year;
+	int last = list->start_year + list->num_year - 1;
+	int rec_size;
+	
+	if( list->num_year > 0 && year >= first && year <= last) return year - first;
+	
+	// 범위를 (최소한 year까지) 두 배로 넓힘
+	if( list->num_year == 0) first = last = year;
+	else if( year < first) first = (year < last - 2 * list->num_year + 1) ? year : last - 2 * list->num_year + 1;
+	else last = (year > first + 2 * list->num_year - 1) ? year : first + 2 * list->num_year - 1;
+	
+	// 모든 블록을 새 크기로 다시 배치
+	rec_size = REC_SIZE(last - first + 1);
+	for( int i = 0; i < list->num_block; i++){
+		tBlock *b = &list->block[i];
+		char *data = (char *)malloc(BLOCK_SIZE * rec_size);
+		
+		for( int j = 0; j < b->len; j++){
+			tName *src = BLOCK_AT(list, b, j);
+			tName *dst = (tName *)(data + (size_t)j * rec_size);
+			
+			memcpy(dst, src, offsetof(tName, freq));
+			memset(dst->freq, 0, (last - first + 1) * sizeof(int));
+			memcpy(dst->freq + (list->start_year - first), src->freq, list->num_year * sizeof(int));
+		}
+		
+		free(b->data);
+		b->data = (tName *)data;
+	}
+	
+	list->start_year = first;
+	list->num_year = last - first + 1;
+	list->rec_size = rec_size;
+	
+	return year - first;
+}
 
-		for(j = 0; j < num_year; j++){
-			printf("	%d", names->data[i].freq[j]);
+void tiered_copy( tTiered *list, tNames *names){
+	int first = list->start_year, last = list->start_year + list->num_year - 1;
+	
+	if( list->num_year == 0) return;
+	
+	// 이름 구조체 배열의 연도 범위를 정렬 리스트의 연도 범위까지 넓힘
+	if( names->num_year > 0){
+		if( names->start_year < first) first = names->start_year;
+		if( names->start_year + names->num_year - 1 > last) last = names->start_year + names->num_year - 1;
+	}
+	
+	if( names->capacity < names->len + list->len){
+		// capacity 가 부족하면 1000 단위로 늘림
+		names->capacity = (names->len + list->len + 999) / 1000 * 1000;
+		names->data = (tName *)realloc(names->data, names->capacity * names->rec_size);
+	}
+	if( names->start_year != first || names->num_year != last - first + 1)
+		resize_years( names, first, last - first + 1);
+	
+	for(int i = 0; i < list->num_block; i++){
+		tBlock *b = &list->block[i];
+		
+		if( names->rec_size == list->rec_size){
+			memcpy(NAME_AT(names, names->len), b->data, b->len * list->rec_size);
+			names->len += b->len;
+			continue;
 		}
+		
+		for(int j = 0; j < b->len; j++){
+			tName *dst = NAME_AT(names, names->len++);
+			
+			memcpy(dst, BLOCK_AT(list, b, j), offsetof(tName, freq));
+			memset(dst->freq, 0, names->num_year * sizeof(int));
+			memcpy(dst->freq + (list->start_year - first), BLOCK_AT(list, b, j)->freq, list->num_year * sizeof(int));
+		}
+	}
+}
 
-		printf("\n");
+// 이름 한 줄을 출력 ("이름\t성별\t빈도...\n")
+static void _print_name( WRITER *out, const tName *p, int num_year){
+	out_Str( out, p->name);
+	out_Char( out, '\t');
+	out_Char( out, p->sex);
+
+	for(int j = 0; j < num_year; j++){
+		out_Char( out, '\t');
+		out_Int( out, p->freq[j]);
 	}
+
+	out_Char( out, '\n');
+}
+
+void print_names( tNames *names){
+	WRITER *out = out_Open( stdout);
+
+	for(int i = 0; i < names->len; i++)
+		_print_name( out, NAME_AT(names, i), names->num_year);
+
+	out_Close( out);
 }
 
 int compare( const void *n1, const void *n2){
-	tName t1 = *(tName*)n1;
-	tName t2 = *(tName*)n2;
+	const tName *t1 = (const tName *)n1;
+	const tName *t2 = (const tName *)n2;
+	int ret = compare_name(t1->name, t2->name);
 
 	// 이름이 같을 경우
-	if( strcmp(t1.name, t2.name) == 0){
-		if(t1.sex == t2.sex) return 0; // 성별도 같을 경우
-		else return (t1.sex > t2.sex) ? 1 : -1; // 성별은 다를 경우
+	if( ret == 0){
+		if(t1->sex == t2->sex) return 0; // 성별도 같을 경우
+		else return (t1->sex > t2->sex) ? 1 : -1; // 성별은 다를 경우
 	}
 	// 이름이 다른 경우
 	else{
-		return strcmp(t1.name, t2.name);
+		return ret;
 	}
 }
 
+int compare_name( const char *a, const char *b){
+	uint32_t ta, tb;
+
+#if defined(__SSE2__)
+	// 앞 16 bytes에서 처음으로 다른 바이트
+	unsigned diff = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)a), _mm_loadu_si128((const __m128i *)b))) ^ 0xFFFF;
+
+	if( diff){
+		int i = __builtin_ctz(diff);
+		return ((unsigned char)a[i] > (unsigned char)b[i]) ? 1 : -1;
+	}
+#else
+	uint64_t wa, wb;
+
+	for(int i = 0; i < 16; i += 8){
+		memcpy(&wa, a + i, 8);
+		memcpy(&wb, b + i, 8);
+		if( wa != wb) return (__builtin_bswap64(wa) > __builtin_bswap64(wb)) ? 1 : -1;
+	}
+#endif
+
+	// 나머지 4 bytes (big-endian으로 바꾸면 정수 비교가 바이트 순서 비교)
+	memcpy(&ta, a + 16, 4);
+	memcpy(&tb, b + 16, 4);
+	if( ta != tb) return (__builtin_bswap32(ta) > __builtin_bswap32(tb)) ? 1 : -1;
+
+	return 0;
+}
+
+void copy_name( char *dst, const char *src){
+	size_t len = strnlen(src, 19);
+
+	memcpy(dst, src, len);
+	memset(dst + len, 0, 20 - len);
+}
+
+int compare_row( const void *r1, const void *r2){
+	const tRow *t1 = (const tRow *)r1;
+	const tRow *t2 = (const tRow *)r2;
+	int ret = compare_name(t1->name, t2->name);
+	
+	if( ret != 0) return ret; // 이름이 다른 경우
+	if( t1->sex != t2->sex) return (t1->sex > t2->sex) ? 1 : -1; // 성별이 다른 경우
+	return t1->seq - t2->seq; // 입력 순서
+}
+
+int compare_query( const void *q1, const void *q2){
+	const tQuery *t1 = (const tQuery *)q1;
+	const tQuery *t2 = (const tQuery *)q2;
+	int ret = compare_name(t1->name, t2->name);
+
+	if( ret != 0) return ret; // 이름이 다른 경우
+	return t1->sex - t2->sex; // 성별
+}
+
 int binary_search( const void *key, const void *base, size_t nmemb, size_t size, int (*compare)(const void *, const void *)){
 	int l = 0, r = 0;
 	int mid, tmp;
@@ -160,8 +720,134 @@ int binary_search( const void *key, const void *base, size_t nmemb, size_t size,
 	
 }
 
+int save_names( tNames *names, const char *path){
+	tSnapHeader header;
+	char tmp_path[1024];
+	FILE *fp;
+	int ok;
+	
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = SNAPSHOT_VERSION;
+	header.count = names->len;
+	header.start_year = names->start_year;
+	header.num_year = names->num_year;
+	header.rec_size = names->rec_size;
+	
+	snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+	fp = fopen( tmp_path, "wb");
+	if (!fp) return 0;
+	
+	ok = (fwrite(&header, sizeof(header), 1, fp) == 1);
+	if (ok && names->len > 0) ok = (fwrite(names->data, names->rec_size, names->len, fp) == (size_t)names->len);
+	if (fclose( fp) != 0) ok = 0;
+	
+	if (ok && rename(tmp_path, path) != 0) ok = 0;
+	if (!ok) remove(tmp_path);
+	
+	return ok;
+}
+
+tNames *open_names( const char *path){
+	tNames *pnames;
+	tSnapHeader *header;
+	struct stat st;
+	void *map;
+	int fd = open(path, O_RDONLY);
+	
+	if (fd < 0) return NULL;
+	
+	if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(tSnapHeader)){
+		close(fd);
+		return NULL;
+	}
+	
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd); // 매핑은 파일을 닫아도 유지됨
+	if (map == MAP_FAILED) return NULL;
+	
+	// 헤더 검사 (형식, 버전, 구조체 크기, 파일 크기)
+	header = (tSnapHeader *)map;
+	if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 || header->version < 1 || header->version > SNAPSHOT_VERSION
+		|| header->num_year < 0 || header->rec_size != (int)REC_SIZE(header->num_year) || header->count < 0
+		|| (off_t)(sizeof(tSnapHeader) + (size_t)header->count * header->rec_size) > st.st_size){
+		munmap(map, st.st_size);
+		return NULL;
+	}
+	
+	pnames = (tNames *)malloc( sizeof(tNames));
+	pnames->len = header->count;
+	pnames->capacity = header->count;
+	pnames->data = (tName *)((char *)map + sizeof(tSnapHeader));
+	pnames->map_size = st.st_size;
+	pnames->start_year = header->start_year;
+	pnames->num_year = header->num_year;
+	pnames->rec_size = header->rec_size;
+	
+	// 버전 1은 이름 뒤가 0으로 채워져 있다는 보장이 없으므로 메모리로 복사하여 채움
+	if (header->version == 1){
+		resize_years( pnames, pnames->start_year, pnames->num_year);
+		
+		for (int i = 0; i < pnames->len; i++){
+			char *name = NAME_AT(pnames, i)->name;
+			size_t len = strnlen(name, 19);
+			
+			memset(name + len, 0, 20 - len);
+		}
+	}
+	
+	return pnames;
+}
+
+// 이름 구조체 배열의 i번째 이름과 조회 key의 비교 (query_Gallop)
+static int _compare_at( const void *table, int i, const void *key){
+	const tName *p = NAME_AT((const tNames *)table, i);
+	const tQuery *q = (const tQuery *)key;
+	int ret = compare_name(p->name, q->name);
+
+	if( ret != 0) return ret; // 이름이 다른 경우
+	return p->sex - q->sex; // 성별
+}
+
+// 배치를 정렬한 후 정렬된 이름 구조체 배열과 한 번의 병합 순회(galloping)로 답함
+static void _answer_gallop( void *table, const tQuery *query, int n, int *found){
+	tQueryTable *t = (tQueryTable *)table;
+	tNames *names = t->names;
+	int pos = 0;
+
+	memcpy(t->sorted, query, n * sizeof(tQuery));
+	qsort(t->sorted, n, sizeof(tQuery), compare_query);
+
+	for (int i = 0; i < n; i++){
+		pos = query_Gallop(names, pos, names->len, &t->sorted[i], _compare_at);
+		found[t->sorted[i].seq] = (pos < names->len && _compare_at(names, pos, &t->sorted[i]) == 0) ? pos : -1;
+	}
+}
+
+// 찾은 이름을 출력 (연도별 빈도)
+static void _print_found( WRITER *out, void *table, int idx){
+	tQueryTable *t = (tQueryTable *)table;
+
+	_print_name(out, NAME_AT(t->names, idx), t->names->num_year);
+}
+
+void query_names( tNames *names, FILE *in){
+	static const tQueryMethod method[] = {
+		{ "gallop", _answer_gallop },
+	};
+	tQueryTable table;
+
+	table.names = names;
+	table.sorted = (tQuery *)malloc(QUERY_BATCH * sizeof(tQuery));
+	if (table.sorted == NULL) return;
+
+	query_Run(in, &table, method, sizeof(method) / sizeof(method[0]), _print_found);
+
+	free(table.sorted);
+}
+
 // 이름 구조체 초기화
-// len를 0으로, capacity를 1로 초기화
+// len를 0으로, capacity를 1로 초기화 (연도 범위는 비어 있음)
 // return : 구조체 포인터
 tNames *create_names(void)
 {
@@ -169,7 +855,11 @@ tNames *create_names(void)
 	
 	pnames->len = 0;
 	pnames->capacity = 1000;
-	pnames->data = (tName *)malloc(pnames->capacity * sizeof(tName));
+	pnames->start_year = 0;
+	pnames->num_year = 0;
+	pnames->rec_size = REC_SIZE(0);
+	pnames->data = (tName *)malloc(pnames->capacity * pnames->rec_size);
+	pnames->map_size = 0;
 
 	return pnames;
 }
@@ -177,7 +867,8 @@ tNames *create_names(void)
 // 이름 구조체에 할당된 메모리를 해제
 void destroy_names(tNames *pnames)
 {
-	free(pnames->data);
+	if (pnames->map_size > 0) munmap((char *)pnames->data - sizeof(tSnapHeader), pnames->map_size);
+	else free(pnames->data);
 	pnames->len = 0;
 	pnames->capacity = 0;
 
@@ -190,12 +881,81 @@ int main(int argc, char **argv)
 	tNames *names;
 	FILE *fp;
 	
-	if (argc != 2)
+	if (argc < 2 || argc > 4 || (argc == 4 && strcmp( argv[1], "-q") != 0))
 	{
-		fprintf( stderr, "Usage: %s FILE\n\n", argv[0]);
+		fprintf( stderr, "Usage: %s FILE [SNAPSHOT]\n", argv[0]);
+		fprintf( stderr, "       %s -m SNAPSHOT\n", argv[0]);
+		fprintf( stderr, "       %s -q FILE [QUERY]\n\n", argv[0]);
 		return 1;
 	}
 
+	if (strcmp( argv[1], "-q") == 0)
+	{
+		FILE *in = stdin;
+
+		if (argc != 3 && argc != 4)
+		{
+			fprintf( stderr, "Usage: %s -q FILE [QUERY]\n\n", argv[0]);
+			return 1;
+		}
+
+		// FILE이 스냅샷이면 매핑하고, 아니면 입력 파일을 읽음 (정렬 리스트)
+		if ((names = open_names( argv[2])) == NULL)
+		{
+			if ((fp = fopen( argv[2], "r")) == NULL)
+			{
+				fprintf( stderr, "cannot open file : %s\n", argv[2]);
+				return 1;
+			}
+
+			names = create_names();
+			if (!load_names( fp, names))
+			{
+				fprintf( stderr, "cannot read file : %s\n", argv[2]);
+				destroy_names( names);
+				fclose( fp);
+				return 1;
+			}
+			fclose( fp);
+		}
+
+		if (argc == 4 && (in = fopen( argv[3], "r")) == NULL)
+		{
+			fprintf( stderr, "cannot open file : %s\n", argv[3]);
+			destroy_names( names);
+			return 1;
+		}
+
+		query_names( names, in);
+
+		if (in != stdin) fclose( in);
+		destroy_names( names);
+		return 0;
+	}
+	
+	if (strcmp( argv[1], "-m") == 0)
+	{
+		if (argc != 3)
+		{
+			fprintf( stderr, "Usage: %s -m SNAPSHOT\n\n", argv[0]);
+			return 1;
+		}
+		
+		// 스냅샷 파일을 매핑 (정렬되어 있음)
+		names = open_names( argv[2]);
+		if (!names)
+		{
+			fprintf( stderr, "cannot open snapshot : %s\n", argv[2]);
+			return 1;
+		}
+		
+		// 이름 구조체를 화면에 출력
+		print_names( names);
+		
+		destroy_names( names);
+		return 0;
+	}
+
 	// 이름 구조체 초기화
 	names = create_names();
 	
@@ -209,12 +969,24 @@ int main(int argc, char **argv)
 	fprintf( stderr, "Processing [%s]..\n", argv[1]);
 		
 	// 연도별 입력 파일(이름 정보)을 구조체에 저장
-	load_names( fp, 2009, names);
+	if (!load_names( fp, names))
+	{
+		fprintf( stderr, "cannot read file : %s\n", argv[1]);
+		destroy_names( names);
+		fclose( fp);
+		return 1;
+	}
 	
 	fclose( fp);
 	
 	// 이름 구조체를 화면에 출력
-	print_names( names, MAX_YEAR_DURATION);
+	print_names( names);
+	
+	// 정렬된 이름 구조체를 스냅샷 파일로 저장
+	if (argc == 3 && !save_names( names, argv[2]))
+	{
+		fprintf( stderr, "cannot write snapshot : %s\n", argv[2]);
+	}
 
 	// 이름 구조체 해제
 	destroy_names( names);
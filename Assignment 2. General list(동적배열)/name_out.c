@@ -0,0 +1,103 @@
+#include <stdlib.h> // malloc, realloc
+#include <string.h> // memcpy, strlen
+
+#include "name_out.h"
+
+#define OUT_BUF_SIZE	(1 << 20)
+
+// internal function
+// 버퍼에 n bytes를 쓸 자리를 확보
+// 파일 버퍼는 내보내서, 메모리 버퍼는 크기를 늘려서 확보
+// return	1 successful
+//			0 if overflow (또는 n이 파일 버퍼보다 큰 경우)
+static int _reserve( WRITER *w, size_t n);
+
+////////////////////////////////////////////////////////////////////////////////
+static int _reserve( WRITER *w, size_t n){
+	if(w->len + n <= w->size) return 1;
+
+	if(w->fp != NULL){
+		out_Flush(w);
+		return (n <= w->size);
+	}
+
+	size_t size = w->size;
+	char *tmp;
+
+	while(size < w->len + n) size *= 2;
+	tmp = (char*)realloc(w->buf, size);
+	if(tmp == NULL) return 0;
+
+	w->buf = tmp;
+	w->size = size;
+
+	return 1;
+}
+
+WRITER *out_Open( FILE *fp){
+	WRITER *w = (WRITER*)malloc(sizeof(WRITER));
+
+	if(w == NULL) return NULL;
+
+	w->fp = fp;
+	w->len = 0;
+	w->size = OUT_BUF_SIZE;
+	w->buf = (char*)malloc(w->size);
+	if(w->buf == NULL){
+		free(w);
+		return NULL;
+	}
+
+	return w;
+}
+
+void out_Close( WRITER *w){
+	out_Flush(w);
+
+	free(w->buf);
+	free(w);
+}
+
+void out_Flush( WRITER *w){
+	if(w->fp == NULL || w->len == 0) return;
+
+	fwrite(w->buf, 1, w->len, w->fp);
+	w->len = 0;
+}
+
+void out_Mem( WRITER *w, const char *s, size_t n){
+	if(!_reserve(w, n)){
+		// 버퍼보다 큰 출력은 바로 내보냄
+		if(w->fp != NULL) fwrite(s, 1, n, w->fp);
+		return;
+	}
+
+	memcpy(w->buf + w->len, s, n);
+	w->len += n;
+}
+
+void out_Str( WRITER *w, const char *s){
+	out_Mem(w, s, strlen(s));
+}
+
+void out_Char( WRITER *w, char c){
+	if(!_reserve(w, 1)) return;
+
+	w->buf[w->len++] = c;
+}
+
+void out_Int( WRITER *w, int v){
+	char tmp[12]; // "-2147483648"
+	char *p = tmp + sizeof(tmp);
+	unsigned u = (v < 0) ? 0u - (unsigned)v : (unsigned)v;
+
+	// 뒤에서부터 한 자리씩
+	do{
+		*--p = '0' + u % 10;
+		u /= 10;
+	} while(u > 0);
+
+	if(v < 0) *--p = '-';
+
+	out_Mem(w, p, tmp + sizeof(tmp) - p);
+}
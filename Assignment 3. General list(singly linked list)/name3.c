@@ -1,32 +1,63 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stddef.h> // offsetof
+#include <stdint.h> // uint32_t, uint64_t
 
-#define MAX_YEAR_DURATION	10	// 기간
+#include "name_scan.h"
+#include "name_out.h"
+#include "adt_pool.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define MAX_LEVEL	16	// skip list의 최대 높이 (node 하나가 level k 이상일 확률은 1/4^k)
+#define POOL_SLOTS	1024	// pool block 하나의 slot 수 (높이가 1인 node)
 
 // 이름 구조체 선언
+// 연도별 빈도는 구조체 뒤에 리스트의 연도의 수(num_year)만큼 이어서 저장됨
+// 이름 뒤의 남은 자리는 0으로 채워짐 (compare_name)
 typedef struct {
 	char	name[20];				// 이름
 	char	sex;					// 성별 M or F
-	int		freq[MAX_YEAR_DURATION]; // 연도별 빈도
+	int		freq[];					// 연도별 빈도 (num_year개)
 } tName;
 
 ////////////////////////////////////////////////////////////////////////////////
-// LIST type definition
+// LIST type definition (skip list)
+// level 0은 모든 node를 순서대로 잇는 정렬 리스트이고,
+// level k (k >= 1)는 level k-1의 node 중 약 1/4만 건너뛰며 이음
 // 데이터노드
+// 이름 구조체는 따로 할당하지 않고 link[level - 1] 바로 뒤에 이어서 저장됨 (NODE_NAME으로 접근)
 typedef struct node
 {
-	tName		*dataPtr; // 이름 정보를 가리키는 포인터
-	struct node	*link; // 다음 node 를 가리키는 포인터
+	int			level; // node의 높이 (1 ~ MAX_LEVEL)
+	struct node	*link[]; // level별 다음 node 를 가리키는 포인터 (level개, link[0]이 다음 node)
 } NODE;
 
 // 헤드노드
 typedef struct
 {
 	int		count; // list 안에 몇 개의 node 가 있는지
-	NODE	*head; // list의 첫번째 node 를 가리키는 포인터
+	int		level; // 가장 높은 node의 높이
+	NODE	*head[MAX_LEVEL]; // level별 첫번째 node 를 가리키는 포인터 (head[0]이 list의 첫번째 node)
+	NODE	*update[MAX_LEVEL]; // _search가 찾은 level별 선행 node (NULL이면 head), _insert와 다음 _search의 시작점(finger)으로 사용
+	unsigned	seed; // node의 높이를 정하는 난수 상태 (xorshift)
+	POOL	*node_pool[MAX_LEVEL]; // 높이별 node의 pool (node_pool[k]는 높이 k+1, slot 크기는 num_year에 맞춤, 처음 쓸 때 생성)
+	int		start_year; // 시작 연도
+	int		num_year; // 연도의 수 (0이면 아직 읽은 연도가 없음)
 } LIST;
 
+// 연도의 수가 num_year인 이름 구조체의 크기
+#define REC_SIZE(num_year)	(offsetof(tName, freq) + (size_t)(num_year) * sizeof(int))
+
+// 높이가 level이고 연도의 수가 num_year인 node의 크기 (이름 구조체 포함)
+#define NODE_SIZE(level, num_year)	(sizeof(NODE) + (size_t)(level) * sizeof(NODE *) + REC_SIZE(num_year))
+
+// node에 들어 있는 이름 구조체
+#define NODE_NAME(pNode)	((tName *)((char *)(pNode)->link + (size_t)(pNode)->level * sizeof(NODE *)))
+
 ////////////////////////////////////////////////////////////////////////////////
 // Prototype declarations
 
@@ -36,27 +67,50 @@ typedef struct
 LIST *createList(void);
 
 //  이름 리스트에 할당된 메모리를 해제 (head node, data node, name data)
+// data node(와 그 안의 이름 구조체)는 pool 단위로 한 번에 해제
 void destroyList( LIST *pList);
 
 // internal insert function
-// inserts data into a new node
-// return	1 if successful
-// 			0 if memory overflow
-static int _insert( LIST *pList, NODE *pPre, tName *dataInPtr);
+// pArgu의 이름과 성별로 새 node를 만들어 삽입 (연도별 빈도는 0)
+// pPre와 level별 선행 node(pList->update)는 직전 _search의 결과여야 함
+// return	새 node의 이름 구조체에 대한 pointer
+// 			NULL if memory overflow
+static tName *_insert( LIST *pList, NODE *pPre, tName *pArgu);
 
 // internal search function
 // searches list and passes back address of node containing target and its logical predecessor
+// 높은 level부터 내려오며 탐색하고, level별 선행 node를 pList->update에 저장 (expected O(log n))
+// pArgu가 직전 탐색 위치보다 뒤에 있으면 그 위치(finger)에서 필요한 level까지만 올라가서 탐색
+// (정렬되었거나 모여 있는 입력은 거리 d에 대해 O(log d))
 // return	1 found
 // 			0 not found
 static int _search( LIST *pList, NODE **pPre, NODE **pLoc, tName *pArgu);
 
-// 이름 구조체를 위한 메모리를 할당하고, 이름(name)과 성별(sex)을 초기화
-// return	할당된 이름 구조체에 대한 pointer
+// internal function
+// 새 node의 높이를 정함 (1/4 확률로 한 단계씩 높아짐)
+static int _random_level( LIST *pList);
+
+// internal function
+// 높이가 level인 node를 현재 연도의 수에 맞는 pool에서 할당 (link와 이름 구조체는 초기화하지 않음)
+// return	node pointer
 //			NULL if overflow
-tName *createName( char *name, char sex); 
+static NODE *_new_node( LIST *pList, int level);
+
+// 연도 범위를 start_year ~ start_year + num_year - 1로 바꾸고 모든 node를 새 크기의 pool로 다시 할당
+// 범위 밖의 연도 빈도는 버려지며, 새로 생긴 연도의 빈도는 0
+// 할당에 실패하면 새 pool만 해제하고 이전 pool과 연결을 되돌림 (리스트는 그대로)
+// return	1 successful
+//			0 if overflow
+int resize_years( LIST *pList, int start_year, int num_year);
+
+// 연도 year의 인덱스 (year - pList->start_year)
+// year가 연도 범위를 벗어나면 범위를 (최소한 두 배로) 넓힘
+// return	연도의 인덱스
+//			-1 if overflow
+int year_index( LIST *pList, int year);
 
-//  이름 구조체에 할당된 메모리를 해제
-void destroyName( tName *pNode);
+// 연도 범위를 빈도가 0이 아닌 연도가 있는 범위로 줄임
+void fit_years( LIST *pList);
 
 ////////////////////////////////////////////////////////////////////////////////
 // 입력 파일을 읽어 이름 정보(연도, 이름, 성별, 빈도)를 이름 리스트에 저장
@@ -64,18 +118,56 @@ void destroyName( tName *pNode);
 // 새로 등장한 이름은 리스트에 추가
 // 주의사항: 동일 이름이 남/여 각각 사용될 수 있으므로, 이름과 성별을 구별해야 함
 // 주의사항: 정렬 리스트(ordered list)를 유지해야 함
-// start_year : 시작 연도 (2009)
-void load_names( FILE *fp, int start_year, LIST *list);
+// 연도 범위는 입력에서 결정 (입력에 등장한 연도 범위)
+// return	1 successful
+//			0 입력을 끝까지 읽지 못한 경우 (메모리 부족, 읽기 오류)
+int load_names( FILE *fp, LIST *list);
 
-// 이름 리스트를 화면에 출력
-void print_names( LIST *pList, int num_year);
+// 이름 리스트를 화면에 출력 (연도 범위의 모든 연도)
+void print_names( LIST *pList);
+
+////////////////////////////////////////////////////////////////////////////////
+// 0으로 채워진 20 bytes 이름 두 개를 비교 (strcmp와 같은 순서)
+// 앞 16 bytes는 SSE2 한 번, 나머지 4 bytes는 byte-swap한 정수 하나로 비교
+// return	음수, 0, 양수 (strcmp와 같은 부호)
+static int compare_name( const char *a, const char *b)
+{
+	uint32_t ta, tb;
+
+#if defined(__SSE2__)
+	// 앞 16 bytes에서 처음으로 다른 바이트
+	unsigned diff = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)a), _mm_loadu_si128((const __m128i *)b))) ^ 0xFFFF;
+
+	if (diff)
+	{
+		int i = __builtin_ctz(diff);
+		return ((unsigned char)a[i] > (unsigned char)b[i]) ? 1 : -1;
+	}
+#else
+	uint64_t wa, wb;
+
+	for (int i = 0; i < 16; i += 8)
+	{
+		memcpy(&wa, a + i, 8);
+		memcpy(&wb, b + i, 8);
+		if (wa != wb) return (__builtin_bswap64(wa) > __builtin_bswap64(wb)) ? 1 : -1;
+	}
+#endif
+
+	// 나머지 4 bytes (big-endian으로 바꾸면 정수 비교가 바이트 순서 비교)
+	memcpy(&ta, a + 16, 4);
+	memcpy(&tb, b + 16, 4);
+	if (ta != tb) return (__builtin_bswap32(ta) > __builtin_bswap32(tb)) ? 1 : -1;
+
+	return 0;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 // compares two names in name structures
 // for _search function
 static int cmpName( const tName *pName1, const tName *pName2)
 {
-	int ret = strcmp( pName1->name, pName2->name);
+	int ret = compare_name( pName1->name, pName2->name);
 	if (ret == 0) return pName1->sex - pName2->sex; // 이름이 같은 경우, 성별 비교
 	else return ret; // 이름이 다른 경우, 1 또는 -1
 }
@@ -107,12 +199,18 @@ int main( int argc, char **argv)
 	}
 	
 	// 입력 파일로부터 이름 정보를 리스트에 저장
-	load_names( fp, 2009, list);
+	if (!load_names( fp, list))
+	{
+		fprintf( stderr, "Error: cannot read file [%s]\n", argv[1]);
+		fclose( fp);
+		destroyList( list);
+		return 2;
+	}
 	
 	fclose( fp);
 	
 	// 이름 리스트를 화면에 출력
-	print_names( list, MAX_YEAR_DURATION);
+	print_names( list);
 	
 	// 이름 리스트 메모리 해제
 	destroyList( list);
@@ -128,138 +226,302 @@ LIST *createList(void){
 	if(key == NULL) return NULL;
 
 	key->count = 0;
-	key->head = NULL;
+	key->level = 1;
+	for(int k = 0; k < MAX_LEVEL; k++) key->head[k] = key->update[k] = NULL;
+	key->seed = 2463534242u;
+	for(int k = 0; k < MAX_LEVEL; k++) key->node_pool[k] = NULL;
+	key->start_year = 0;
+	key->num_year = 0;
 
 	return key;
 }
 
 void destroyList( LIST *pList){ 
-	// data node 해제
-	// dataPtr 에 저장된 이름 정보 해제
-	NODE *pLoc = pList->head;
-	NODE *pNext;
+	// data node와 그 안에 저장된 이름 정보 해제 (높이별 pool)
+	for(int k = 0; k < MAX_LEVEL; k++)
+		if(pList->node_pool[k] != NULL) pool_Destroy(pList->node_pool[k]);
+	
+	free(pList); // head node 해제
+}
 
-	while(pLoc != NULL){
-		pNext = pLoc->link;
-		destroyName(pLoc->dataPtr);
-		free(pLoc);
+static int _random_level( LIST *pList){
+	unsigned r;
+	int level = 1;
 
-		pLoc = pNext; // head node 해제
+	// xorshift32
+	pList->seed ^= pList->seed << 13;
+	pList->seed ^= pList->seed >> 17;
+	pList->seed ^= pList->seed << 5;
+	r = pList->seed;
+
+	// 2비트가 모두 0일 때마다 (1/4) 한 단계 높임
+	while((r & 3) == 0 && level < MAX_LEVEL){
+		level++;
+		r >>= 2;
 	}
-	
-	free(pList);
+
+	return level;
 }
 
-static int _insert( LIST *pList, NODE *pPre, tName *dataInPtr){ 
-	NODE* pNew = (NODE*)malloc(sizeof(NODE));
+static NODE *_new_node( LIST *pList, int level){
+	NODE *pNew;
+
+	// 높이별 pool (높은 node일수록 드물므로 block을 작게 잡음)
+	if(pList->node_pool[level - 1] == NULL)
+		pList->node_pool[level - 1] = pool_Create(NODE_SIZE(level, pList->num_year), POOL_SLOTS >> (2 * (level - 1)));
+	if(pList->node_pool[level - 1] == NULL) return NULL;
+
+	pNew = (NODE*)pool_Alloc(pList->node_pool[level - 1]);
 
 	// overflow
-	if(pNew == NULL) return 0;
-	
-	pNew->dataPtr = dataInPtr;
-	pNew->link=NULL;
+	if(pNew == NULL) return NULL;
 
-	if(pPre == NULL){ //맨 앞인 경우
-		pNew->link=pList->head;
-		pList->head = pNew;
-		
-	}
+	pNew->level = level;
+
+	return pNew;
+}
 
-	else{
-	//맨 끝인 경우 -> pLoc이 NULL이 되면
-	//맨 끝에 삽입하는 작업 예외 처리
-		if(pPre->link == NULL){
-			pPre->link = pNew;
-		}	
+static tName *_insert( LIST *pList, NODE *pPre, tName *pArgu){ 
+	int level = _random_level(pList);
+	NODE* pNew = _new_node(pList, level);
+	tName *key;
 
+	// overflow
+	if(pNew == NULL) return NULL;
+
+	// 이름 구조체는 node 안에 있음 (이름 뒤의 남은 자리는 이미 0으로 채워져 있음)
+	key = NODE_NAME(pNew);
+	memcpy(key->name, pArgu->name, sizeof(key->name));
+	key->sex = pArgu->sex;
+	memset(key->freq, 0, pList->num_year * sizeof(int));
+
+	// 지금까지보다 높은 level의 선행 node는 head
+	for(int k = pList->level; k < level; k++) pList->update[k] = NULL;
+	if(level > pList->level) pList->level = level;
+	pList->update[0] = pPre;
+
+	// level별로 선행 node 다음에 연결 (선행 node가 NULL이면 맨 앞)
+	for(int k = 0; k < level; k++){
+		NODE *pre = pList->update[k];
+
+		if(pre == NULL){
+			pNew->link[k] = pList->head[k];
+			pList->head[k] = pNew;
+		}
 		else{
-			pNew->link = pPre->link;
-			pPre->link = pNew;
+			pNew->link[k] = pre->link[k];
+			pre->link[k] = pNew;
 		}
 	}
+
+	pList->count++;
 	
-	return 1;
+	return key;
 
 }
 
 static int _search( LIST *pList, NODE **pPre, NODE **pLoc, tName *pArgu){
-	*pPre = NULL; // pPre: 선행 node
-	*pLoc = pList->head; // pLoc: 현재 node
+	NODE *pre = NULL; // 선행 node (NULL이면 head)
+	int top = pList->level - 1; // 탐색을 시작할 level
+
+	// 직전 탐색의 선행 node(update)가 pArgu보다 작으면 거기서 시작
+	// 다음 node가 pArgu보다 작지 않은 가장 낮은 level까지만 올라감 (그보다 높은 level의 update는 그대로 유효)
+	if(pList->update[0] != NULL && cmpName(pArgu, NODE_NAME(pList->update[0])) > 0){
+		for(top = 0; top < pList->level - 1; top++){
+			NODE *next = (pList->update[top] == NULL) ? pList->head[top] : pList->update[top]->link[top];
 
-	while(*pLoc != NULL){
-		int tmp = cmpName(pArgu, (*pLoc)->dataPtr); // 음수, 양수, 0
+			if(next == NULL || cmpName(pArgu, NODE_NAME(next)) <= 0) break;
+		}
+		pre = pList->update[top];
+	}
 
-		if(*pLoc == NULL) return 0;
+	// 높은 level부터 pArgu보다 작은 마지막 node까지 이동
+	for(int k = top; k >= 0; k--){
+		NODE *next = (pre == NULL) ? pList->head[k] : pre->link[k];
 
-		if(tmp == 0) return 1;
-		if(tmp < 0) return 0;
-		if(tmp > 0){
-			*pPre = *pLoc;
-			*pLoc = (*pLoc)->link;
+		while(next != NULL && cmpName(pArgu, NODE_NAME(next)) > 0){
+			pre = next;
+			next = next->link[k];
 		}
+
+		pList->update[k] = pre;
 	}
 
-	return 0;
+	*pPre = pre; // pPre: 선행 node
+	*pLoc = (pre == NULL) ? pList->head[0] : pre->link[0]; // pLoc: 현재 node
+
+	return (*pLoc != NULL && cmpName(pArgu, NODE_NAME(*pLoc)) == 0);
 }
 
-tName *createName( char *name, char sex){
-	tName* key = (tName*)malloc(sizeof(tName));
+int resize_years( LIST *pList, int start_year, int num_year){
+	// 이전 범위와 새 범위가 겹치는 연도 [lo, hi)
+	int lo = (start_year > pList->start_year) ? start_year : pList->start_year;
+	int hi = (start_year + num_year < pList->start_year + pList->num_year) ? start_year + num_year : pList->start_year + pList->num_year;
+	int old_start = pList->start_year;
+	int old_num = pList->num_year;
+	POOL *old_pool[MAX_LEVEL]; // 이전 크기의 node pool
+	NODE *old_head[MAX_LEVEL]; // 이전 node의 level별 연결 (실패하면 되돌림)
+	NODE *pLoc = pList->head[0];
+	NODE *last[MAX_LEVEL]; // level별로 마지막에 연결한 새 node (NULL이면 아직 없음)
+
+	for(int k = 0; k < MAX_LEVEL; k++){
+		old_pool[k] = pList->node_pool[k];
+		old_head[k] = pList->head[k];
+		pList->node_pool[k] = NULL;
+		pList->head[k] = last[k] = pList->update[k] = NULL;
+	}
 
-	// overflow
-	if(key == NULL) return NULL;
+	pList->start_year = start_year;
+	pList->num_year = num_year;
+
+	// node를 순서대로 새 크기로 복사하며 level별 연결을 다시 만듦 (높이는 그대로)
+	for(; pLoc != NULL; pLoc = pLoc->link[0]){
+		tName *old = NODE_NAME(pLoc);
+		NODE *pNew = _new_node(pList, pLoc->level);
+		tName *key;
+
+		// overflow: 새 pool을 해제하고 이전 node로 되돌림 (이전 node는 읽기만 했으므로 그대로)
+		if(pNew == NULL){
+			for(int k = 0; k < MAX_LEVEL; k++){
+				if(pList->node_pool[k] != NULL) pool_Destroy(pList->node_pool[k]);
+				pList->node_pool[k] = old_pool[k];
+				pList->head[k] = old_head[k];
+			}
+			pList->start_year = old_start;
+			pList->num_year = old_num;
+
+			return 0;
+		}
 
-	strcpy(key->name, name);
-	key->sex = sex;
-	
-	for (int i = 0; i < 10; i++)
-		key->freq[i] = 0;
+		key = NODE_NAME(pNew);
+		memcpy(key, old, offsetof(tName, freq));
+		memset(key->freq, 0, num_year * sizeof(int));
+		if(lo < hi) memcpy(key->freq + (lo - start_year), old->freq + (lo - old_start), (hi - lo) * sizeof(int));
 
-	return key;
+		for(int k = 0; k < pNew->level; k++){
+			if(last[k] == NULL) pList->head[k] = pNew;
+			else last[k]->link[k] = pNew;
+
+			pNew->link[k] = NULL;
+			last[k] = pNew;
+		}
+	}
+
+	// 이전 크기의 node는 한 번에 해제
+	for(int k = 0; k < MAX_LEVEL; k++)
+		if(old_pool[k] != NULL) pool_Destroy(old_pool[k]);
+
+	return 1;
+}
+
+int year_index( LIST *pList, int year){
+	int first = pList->start_year;
+	int last = pList->start_year + pList->num_year - 1;
+
+	if(pList->num_year > 0 && year >= first && year <= last) return year - first;
+
+	// 범위를 (최소한 year까지) 두 배로 넓힘
+	if(pList->num_year == 0) first = last = year;
+	else if(year < first) first = (year < last - 2 * pList->num_year + 1) ? year : last - 2 * pList->num_year + 1;
+	else last = (year > first + 2 * pList->num_year - 1) ? year : first + 2 * pList->num_year - 1;
+
+	if(resize_years(pList, first, last - first + 1) == 0) return -1;
+
+	return year - first;
 }
 
-void destroyName( tName *pNode){
+void fit_years( LIST *pList){
+	int first = pList->num_year, last = -1; // 빈도가 0이 아닌 첫번째, 마지막 연도 인덱스
+
+	for(NODE *pLoc = pList->head[0]; pLoc != NULL; pLoc = pLoc->link[0]){
+		for(int y = 0; y < first; y++)
+			if(NODE_NAME(pLoc)->freq[y] != 0){
+				first = y;
+				break;
+			}
+		for(int y = pList->num_year - 1; y > last; y--)
+			if(NODE_NAME(pLoc)->freq[y] != 0){
+				last = y;
+				break;
+			}
+	}
+
+	if(first > last) return; // 빈도가 있는 연도가 없음
+	if(first == 0 && last == pList->num_year - 1) return;
 
-	free(pNode);
+	resize_years(pList, pList->start_year + first, last - first + 1);
 }
 
-void load_names( FILE *fp, int start_year, LIST *list){
+int load_names( FILE *fp, LIST *list){
 
-	char tmp_name[20], tmp_sex;
-	int tmp_year, tmp_freq;
+	int tmp_year;
+	int ok = 1;
 
 	NODE *pPre = NULL;
 	NODE *pLoc = NULL;
 	tName *find = NULL;
+	tName probe; // 검색할 이름과 성별 (빈도는 쓰지 않으므로 stack에 둠)
+	SCANNER *sc = scan_Open( fp);
+	tRecord rec;
 
-	while(!feof( fp)){
-		fscanf( fp, "%d %s %c %d", &tmp_year, tmp_name, &tmp_sex, &tmp_freq);
+	if(sc == NULL) return 0;
 
-		find = createName(tmp_name, tmp_sex);
+	while(scan_Next( sc, &rec)){
+		scan_Copy( &rec, probe.name, sizeof(probe.name));
+		probe.sex = rec.sex;
+
+		tmp_year = year_index(list, rec.year);
+		if(tmp_year < 0){
+			ok = 0;
+			break;
+		}
 
 		// 이름과 성별이 모두 같은 경우
-		if( _search(list, &pPre, &pLoc, find) == 1){
-			pLoc->dataPtr->freq[tmp_year - start_year] = tmp_freq;
-			free(find);
+		if( _search(list, &pPre, &pLoc, &probe) == 1){
+			NODE_NAME(pLoc)->freq[tmp_year] = rec.freq;
 		}
 		else{
-			find->freq[tmp_year-start_year]=tmp_freq;
-			_insert(list, pPre, find);																																							
+			// 새로 등장한 이름만 node(와 이름 구조체)를 할당
+			find = _insert(list, pPre, &probe);
+			if(find == NULL){
+				ok = 0;
+				break;
+			}
+
+			find->freq[tmp_year] = rec.freq;
 		}  
 
 	}
 
+	if(sc->error) ok = 0;
+
+	fit_years( list);
+
+	scan_Close( sc);
+
+	return ok;
 }
 
-void print_names( LIST *pList, int num_year){
-	NODE* pLoc = pList->head;
+void print_names( LIST *pList){
+	NODE* pLoc = pList->head[0];
+	WRITER *out = out_Open(stdout);
+
 	while(pLoc != NULL){
-		printf("%s\t%c", pLoc->dataPtr->name, pLoc->dataPtr->sex);
+		tName *key = NODE_NAME(pLoc);
+
+		out_Str(out, key->name);
+		out_Char(out, '\t');
+		out_Char(out, key->sex);
 		
-		for(int i = 0; i < num_year; i++)
-			printf("\t%d", pLoc->dataPtr->freq[i]);
+		for(int i = 0; i < pList->num_year; i++){
+			out_Char(out, '\t');
+			out_Int(out, key->freq[i]);
+		}
 
-		printf("\n");
+		out_Char(out, '\n');
 
-		pLoc = pLoc->link;
+		pLoc = pLoc->link[0];
 	}
+
+	out_Close(out);
 }
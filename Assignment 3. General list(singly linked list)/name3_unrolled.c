@@ -0,0 +1,637 @@
+// name3.c의 unrolled linked list 버전
+// node 하나에 이름 구조체 여러 개(NODE_CAP)를 정렬된 순서로 이어서 저장
+// node 헤더에 마지막 이름을 복사해 두어, 탐색 중 건너뛰는 node는 헤더만 읽음
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stddef.h> // offsetof
+#include <stdint.h> // uint32_t, uint64_t
+
+#include "name_scan.h"
+#include "name_out.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define NODE_CAP	16	// node 하나에 저장하는 이름 구조체의 최대 수
+#define NODE_MIN	(NODE_CAP / 4)	// 삭제 후 이보다 적게 남으면 다음 node와 합침
+
+// 이름 구조체 선언
+// 연도별 빈도는 구조체 뒤에 리스트의 연도의 수(num_year)만큼 이어서 저장됨
+// 이름 뒤의 남은 자리는 0으로 채워짐 (compare_name)
+typedef struct {
+	char	name[20];				// 이름
+	char	sex;					// 성별 M or F
+	int		freq[];					// 연도별 빈도 (num_year개)
+} tName;
+
+////////////////////////////////////////////////////////////////////////////////
+// LIST type definition (unrolled linked list)
+// 데이터노드
+typedef struct node
+{
+	struct node	*link; // 다음 node 를 가리키는 포인터
+	int			count; // node에 저장된 이름 구조체의 수 (1 ~ NODE_CAP)
+	char		max_name[20]; // node의 마지막 이름 (탐색 시 건너뛸지 헤더만 보고 정함)
+	char		max_sex; // node의 마지막 이름의 성별
+	int			data[]; // 이름 구조체 NODE_CAP개 (크기가 rec_size이므로 NAME_AT으로 접근)
+} NODE;
+
+// 헤드노드
+typedef struct
+{
+	int		count; // list 안에 몇 개의 이름이 있는지
+	NODE	*head; // list의 첫번째 node 를 가리키는 포인터
+	NODE	*finger; // 마지막으로 찾은 node (다음 _search의 시작점, NULL이면 head)
+	NODE	*finger_pre; // finger의 선행 node (NULL이면 head)
+	int		start_year; // 시작 연도
+	int		num_year; // 연도의 수 (0이면 아직 읽은 연도가 없음)
+	int		rec_size; // 이름 구조체 하나의 크기 (REC_SIZE(num_year))
+} LIST;
+
+// 연도의 수가 num_year인 이름 구조체의 크기
+#define REC_SIZE(num_year)	(offsetof(tName, freq) + (size_t)(num_year) * sizeof(int))
+
+// node의 i번째 이름 구조체
+#define NAME_AT(pList, pNode, i)	((tName *)((char *)(pNode)->data + (size_t)(i) * (pList)->rec_size))
+
+////////////////////////////////////////////////////////////////////////////////
+// Prototype declarations
+
+// Allocates dynamic memory for a list head node and returns its address to caller
+// return	head node pointer
+// 			NULL if overflow
+LIST *createList(void);
+
+//  이름 리스트에 할당된 메모리를 해제 (head node, data node, name data)
+void destroyList( LIST *pList);
+
+// 이름(name)과 성별(sex)이 같은 이름 구조체를 리스트에서 삭제
+// 거의 빈 node는 다음 node와 합침
+// return	1 deleted
+//			0 not found
+int removeName( LIST *pList, char *name, char sex);
+
+// internal function
+// 현재 연도의 수로 빈 node를 할당
+// return	node pointer
+//			NULL if overflow
+static NODE *_new_node( LIST *pList);
+
+// internal function
+// node의 마지막 이름을 헤더에 복사
+static void _fence( LIST *pList, NODE *pNode);
+
+// internal insert function
+// pLoc의 idx번째 자리에 pArgu의 이름과 성별로 새 이름 구조체를 만듦 (빈도는 0)
+// 가득 찬 node는 둘로 나눔
+// pLoc, idx는 직전 _search의 결과여야 함
+// return	새 이름 구조체에 대한 pointer
+// 			NULL if memory overflow
+static tName *_insert( LIST *pList, NODE *pLoc, int idx, tName *pArgu);
+
+// internal delete function
+// pLoc의 idx번째 이름 구조체를 삭제
+static void _delete( LIST *pList, NODE *pPre, NODE *pLoc, int idx);
+
+// internal search function
+// pArgu보다 작지 않은 첫번째 이름 구조체의 node(pLoc)와 그 안의 위치(pIdx), pLoc의 선행 node(pPre)를 넘겨줌
+// pArgu가 모든 이름보다 뒤이면 마지막 node의 끝 (pLoc->count)
+// pArgu가 직전 탐색 위치보다 뒤에 있으면 그 node(finger)에서 시작
+// return	1 found
+// 			0 not found
+static int _search( LIST *pList, NODE **pPre, NODE **pLoc, int *pIdx, tName *pArgu);
+
+// 연도 범위를 start_year ~ start_year + num_year - 1로 바꾸고 모든 node를 새 크기로 다시 할당
+// 범위 밖의 연도 빈도는 버려지며, 새로 생긴 연도의 빈도는 0
+// 새 node를 모두 할당한 후에 옮기므로, 실패하면 리스트는 그대로 남음
+// return	1 successful
+// 			0 if memory overflow
+int resize_years( LIST *pList, int start_year, int num_year);
+
+// 연도 year의 인덱스 (year - pList->start_year)
+// year가 연도 범위를 벗어나면 범위를 (최소한 두 배로) 넓힘
+// return	연도의 인덱스
+// 			-1 if memory overflow
+int year_index( LIST *pList, int year);
+
+// 연도 범위를 빈도가 0이 아닌 연도가 있는 범위로 줄임
+void fit_years( LIST *pList);
+
+////////////////////////////////////////////////////////////////////////////////
+// 입력 파일을 읽어 이름 정보(연도, 이름, 성별, 빈도)를 이름 리스트에 저장
+// 이미 리스트에 존재하는(저장된) 이름은 해당 연도의 빈도만 저장
+// 새로 등장한 이름은 리스트에 추가
+// 주의사항: 동일 이름이 남/여 각각 사용될 수 있으므로, 이름과 성별을 구별해야 함
+// 주의사항: 정렬 리스트(ordered list)를 유지해야 함
+// 연도 범위는 입력에서 결정 (입력에 등장한 연도 범위)
+// return	1 successful
+//			0 입력을 끝까지 읽지 못한 경우 (메모리 부족, 읽기 오류)
+int load_names( FILE *fp, LIST *list);
+
+// 이름 리스트를 화면에 출력 (연도 범위의 모든 연도)
+void print_names( LIST *pList);
+
+// 삭제 파일에서 "이름 성별"을 한 줄씩 읽어 이름 리스트에서 삭제 (removeName)
+// 연도 범위는 바꾸지 않음
+// return	삭제된 이름의 수
+int remove_names( FILE *fp, LIST *list);
+
+////////////////////////////////////////////////////////////////////////////////
+// 0으로 채워진 20 bytes 이름 두 개를 비교 (strcmp와 같은 순서)
+// 앞 16 bytes는 SSE2 한 번, 나머지 4 bytes는 byte-swap한 정수 하나로 비교
+// return	음수, 0, 양수 (strcmp와 같은 부호)
+static int compare_name( const char *a, const char *b)
+{
+	uint32_t ta, tb;
+
+#if defined(__SSE2__)
+	// 앞 16 bytes에서 처음으로 다른 바이트
+	unsigned diff = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)a), _mm_loadu_si128((const __m128i *)b))) ^ 0xFFFF;
+
+	if (diff)
+	{
+		int i = __builtin_ctz(diff);
+		return ((unsigned char)a[i] > (unsigned char)b[i]) ? 1 : -1;
+	}
+#else
+	uint64_t wa, wb;
+
+	for (int i = 0; i < 16; i += 8)
+	{
+		memcpy(&wa, a + i, 8);
+		memcpy(&wb, b + i, 8);
+		if (wa != wb) return (__builtin_bswap64(wa) > __builtin_bswap64(wb)) ? 1 : -1;
+	}
+#endif
+
+	// 나머지 4 bytes (big-endian으로 바꾸면 정수 비교가 바이트 순서 비교)
+	memcpy(&ta, a + 16, 4);
+	memcpy(&tb, b + 16, 4);
+	if (ta != tb) return (__builtin_bswap32(ta) > __builtin_bswap32(tb)) ? 1 : -1;
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// compares a name in name structure with name and sex
+// for _search function
+static int cmpKey( const tName *pArgu, const char *name, char sex)
+{
+	int ret = compare_name( pArgu->name, name);
+	if (ret == 0) return pArgu->sex - sex; // 이름이 같은 경우, 성별 비교
+	else return ret; // 이름이 다른 경우, 1 또는 -1
+}
+
+// compares two names in name structures
+static int cmpName( const tName *pName1, const tName *pName2)
+{
+	return cmpKey( pName1, pName2->name, pName2->sex);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main( int argc, char **argv)
+{
+	LIST *list;
+	FILE *fp;
+
+	if (argc != 2 && argc != 3){
+		fprintf( stderr, "usage: %s FILE [DELETE]\n\n", argv[0]);
+		fprintf( stderr, "DELETE\n\tremoves the \"name sex\" lines in DELETE from the list before printing\n");
+		return 1;
+	}
+
+	fp = fopen( argv[1], "rt");
+	if (!fp)
+	{
+		fprintf( stderr, "Error: cannot open file [%s]\n", argv[1]);
+		return 2;
+	}
+
+	// creates an empty list
+	list = createList();
+	if (!list)
+	{
+		printf( "Cannot create list\n");
+		return 100;
+	}
+
+	// 입력 파일로부터 이름 정보를 리스트에 저장
+	if (!load_names( fp, list))
+	{
+		fprintf( stderr, "Error: cannot read file [%s]\n", argv[1]);
+		fclose( fp);
+		destroyList( list);
+		return 2;
+	}
+
+	fclose( fp);
+
+	// 삭제 파일의 이름들을 리스트에서 삭제
+	if (argc == 3)
+	{
+		fp = fopen( argv[2], "rt");
+		if (!fp)
+		{
+			fprintf( stderr, "Error: cannot open file [%s]\n", argv[2]);
+			destroyList( list);
+			return 2;
+		}
+
+		fprintf( stderr, "%d names deleted\n", remove_names( fp, list));
+
+		fclose( fp);
+	}
+
+	// 이름 리스트를 화면에 출력
+	print_names( list);
+
+	// 이름 리스트 메모리 해제
+	destroyList( list);
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LIST *createList(void){
+	LIST* key = (LIST*)malloc(sizeof(LIST));
+
+	// overflow
+	if(key == NULL) return NULL;
+
+	key->count = 0;
+	key->head = NULL;
+	key->finger = key->finger_pre = NULL;
+	key->start_year = 0;
+	key->num_year = 0;
+	key->rec_size = REC_SIZE(0);
+
+	return key;
+}
+
+void destroyList( LIST *pList){
+	// data node 해제 (이름 구조체는 node 안에 있음)
+	NODE *pLoc = pList->head;
+	NODE *pNext;
+
+	while(pLoc != NULL){
+		pNext = pLoc->link;
+		free(pLoc);
+
+		pLoc = pNext;
+	}
+
+	free(pList); // head node 해제
+}
+
+int removeName( LIST *pList, char *name, char sex){
+	NODE *pPre, *pLoc;
+	int idx;
+	tName probe; // 검색할 이름과 성별
+	size_t len = strnlen(name, sizeof(probe.name) - 1);
+
+	memcpy(probe.name, name, len);
+	memset(probe.name + len, 0, sizeof(probe.name) - len);
+	probe.sex = sex;
+
+	if(_search(pList, &pPre, &pLoc, &idx, &probe) == 0) return 0;
+
+	_delete(pList, pPre, pLoc, idx);
+
+	return 1;
+}
+
+static NODE *_new_node( LIST *pList){
+	NODE *pNew = (NODE*)malloc(sizeof(NODE) + NODE_CAP * pList->rec_size);
+
+	// overflow
+	if(pNew == NULL) return NULL;
+
+	pNew->link = NULL;
+	pNew->count = 0;
+
+	return pNew;
+}
+
+static void _fence( LIST *pList, NODE *pNode){
+	tName *last = NAME_AT(pList, pNode, pNode->count - 1);
+
+	memcpy(pNode->max_name, last->name, sizeof(pNode->max_name));
+	pNode->max_sex = last->sex;
+}
+
+static tName *_insert( LIST *pList, NODE *pLoc, int idx, tName *pArgu){
+	tName *key;
+
+	if(pLoc == NULL){ // 빈 리스트
+		pLoc = _new_node(pList);
+		if(pLoc == NULL) return NULL;
+
+		pList->head = pLoc;
+		pList->finger = pLoc;
+		pList->finger_pre = NULL;
+	}
+	else if(pLoc->count == NODE_CAP){ // 가득 찬 node는 둘로 나눔
+		// 맨 끝에 추가하는 경우(정렬된 입력)는 새 node를 비워서 시작, 아니면 반씩 나눔
+		int half = (idx == NODE_CAP) ? NODE_CAP : NODE_CAP / 2;
+		NODE *pNew = _new_node(pList);
+		if(pNew == NULL) return NULL;
+
+		memcpy(pNew->data, NAME_AT(pList, pLoc, half), (size_t)(NODE_CAP - half) * pList->rec_size);
+		pNew->count = NODE_CAP - half;
+		pLoc->count = half;
+
+		pNew->link = pLoc->link;
+		pLoc->link = pNew;
+
+		_fence(pList, pLoc);
+		if(pNew->count > 0) _fence(pList, pNew);
+
+		// 새 자리가 뒤쪽 node에 있으면 그 node에 삽입
+		if(idx >= half){
+			pList->finger_pre = pLoc;
+			pList->finger = pNew;
+
+			pLoc = pNew;
+			idx -= half;
+		}
+	}
+
+	// 뒤의 이름 구조체를 한 칸씩 밀고 빈 자리에 삽입
+	memmove(NAME_AT(pList, pLoc, idx + 1), NAME_AT(pList, pLoc, idx), (size_t)(pLoc->count - idx) * pList->rec_size);
+
+	key = NAME_AT(pList, pLoc, idx);
+	memcpy(key->name, pArgu->name, sizeof(key->name));
+	key->sex = pArgu->sex;
+	memset(key->freq, 0, pList->num_year * sizeof(int));
+
+	pLoc->count++;
+	pList->count++;
+
+	if(idx == pLoc->count - 1) _fence(pList, pLoc); // 마지막 이름이 바뀜
+
+	return key;
+}
+
+static void _delete( LIST *pList, NODE *pPre, NODE *pLoc, int idx){
+	NODE *pNext = pLoc->link;
+
+	// 뒤의 이름 구조체를 한 칸씩 당김
+	memmove(NAME_AT(pList, pLoc, idx), NAME_AT(pList, pLoc, idx + 1), (size_t)(pLoc->count - idx - 1) * pList->rec_size);
+	pLoc->count--;
+	pList->count--;
+
+	if(pLoc->count == 0){ // 빈 node는 list에서 뺌
+		if(pPre == NULL) pList->head = pNext;
+		else pPre->link = pNext;
+		free(pLoc);
+	}
+	else{
+		// 거의 빈 node는 다음 node와 합침
+		if(pLoc->count < NODE_MIN && pNext != NULL && pLoc->count + pNext->count <= NODE_CAP){
+			memcpy(NAME_AT(pList, pLoc, pLoc->count), pNext->data, (size_t)pNext->count * pList->rec_size);
+			pLoc->count += pNext->count;
+			pLoc->link = pNext->link;
+			free(pNext);
+		}
+
+		_fence(pList, pLoc);
+	}
+
+	// finger가 없어진 node를 가리킬 수 있음
+	pList->finger = pList->finger_pre = NULL;
+}
+
+static int _search( LIST *pList, NODE **pPre, NODE **pLoc, int *pIdx, tName *pArgu){
+	NODE *pre = NULL; // 선행 node (NULL이면 head)
+	NODE *loc = pList->head; // 현재 node
+	int lo, hi;
+
+	// finger node의 첫 이름과 같거나 뒤이면 finger에서 시작
+	if(pList->finger != NULL && cmpName(pArgu, NAME_AT(pList, pList->finger, 0)) >= 0){
+		pre = pList->finger_pre;
+		loc = pList->finger;
+	}
+
+	if(loc == NULL){ // 빈 리스트
+		*pPre = NULL;
+		*pLoc = NULL;
+		*pIdx = 0;
+		return 0;
+	}
+
+	// 마지막 이름이 pArgu보다 작은 node는 건너뜀 (마지막 node에서는 멈춤)
+	while(loc->link != NULL && cmpKey(pArgu, loc->max_name, loc->max_sex) > 0){
+		pre = loc;
+		loc = loc->link;
+	}
+
+	// node 안에서 pArgu보다 작지 않은 첫번째 이름 (이진 탐색)
+	lo = 0;
+	hi = loc->count;
+	while(lo < hi){
+		int mid = (lo + hi) / 2;
+
+		if(cmpName(pArgu, NAME_AT(pList, loc, mid)) > 0) lo = mid + 1;
+		else hi = mid;
+	}
+
+	pList->finger = loc;
+	pList->finger_pre = pre;
+
+	*pPre = pre;
+	*pLoc = loc;
+	*pIdx = lo;
+
+	return (lo < loc->count && cmpName(pArgu, NAME_AT(pList, loc, lo)) == 0);
+}
+
+int resize_years( LIST *pList, int start_year, int num_year){
+	// 이전 범위와 새 범위가 겹치는 연도 [lo, hi)
+	int lo = (start_year > pList->start_year) ? start_year : pList->start_year;
+	int hi = (start_year + num_year < pList->start_year + pList->num_year) ? start_year + num_year : pList->start_year + pList->num_year;
+	int old_size = pList->rec_size;
+	NODE *first = NULL; // 새 크기로 할당한 node들 (기존 node와 같은 순서로 연결)
+	NODE **ppLink = &first;
+	NODE *old, *pNew;
+
+	// 새 node를 모두 먼저 할당
+	for(old = pList->head; old != NULL; old = old->link){
+		*ppLink = (NODE*)malloc(sizeof(NODE) + NODE_CAP * REC_SIZE(num_year));
+
+		// overflow: 할당한 node만 해제하고 리스트는 그대로 둠
+		if(*ppLink == NULL){
+			while(first != NULL){
+				pNew = first->link;
+				free(first);
+				first = pNew;
+			}
+			return 0;
+		}
+
+		ppLink = &(*ppLink)->link;
+	}
+	*ppLink = NULL;
+
+	pList->rec_size = REC_SIZE(num_year);
+
+	old = pList->head;
+	pList->head = first;
+
+	for(pNew = first; pNew != NULL; pNew = pNew->link){
+		NODE *pNext = old->link;
+		NODE *pNewNext = pNew->link;
+
+		// 헤더 (count, 마지막 이름)는 그대로
+		memcpy(pNew, old, sizeof(NODE));
+		pNew->link = pNewNext;
+
+		for(int i = 0; i < old->count; i++){
+			tName *src = (tName *)((char *)old->data + (size_t)i * old_size);
+			tName *key = NAME_AT(pList, pNew, i);
+
+			memcpy(key, src, offsetof(tName, freq));
+			memset(key->freq, 0, num_year * sizeof(int));
+			if(lo < hi) memcpy(key->freq + (lo - start_year), src->freq + (lo - pList->start_year), (hi - lo) * sizeof(int));
+		}
+
+		free(old);
+		old = pNext;
+	}
+
+	pList->finger = pList->finger_pre = NULL;
+
+	pList->start_year = start_year;
+	pList->num_year = num_year;
+
+	return 1;
+}
+
+int year_index( LIST *pList, int year){
+	int first = pList->start_year;
+	int last = pList->start_year + pList->num_year - 1;
+
+	if(pList->num_year > 0 && year >= first && year <= last) return year - first;
+
+	// 범위를 (최소한 year까지) 두 배로 넓힘
+	if(pList->num_year == 0) first = last = year;
+	else if(year < first) first = (year < last - 2 * pList->num_year + 1) ? year : last - 2 * pList->num_year + 1;
+	else last = (year > first + 2 * pList->num_year - 1) ? year : first + 2 * pList->num_year - 1;
+
+	if(resize_years(pList, first, last - first + 1) == 0) return -1;
+
+	return year - first;
+}
+
+void fit_years( LIST *pList){
+	int first = pList->num_year, last = -1; // 빈도가 0이 아닌 첫번째, 마지막 연도 인덱스
+
+	for(NODE *pLoc = pList->head; pLoc != NULL; pLoc = pLoc->link){
+		for(int i = 0; i < pLoc->count; i++){
+			tName *key = NAME_AT(pList, pLoc, i);
+
+			for(int y = 0; y < first; y++)
+				if(key->freq[y] != 0){
+					first = y;
+					break;
+				}
+			for(int y = pList->num_year - 1; y > last; y--)
+				if(key->freq[y] != 0){
+					last = y;
+					break;
+				}
+		}
+	}
+
+	if(first > last) return; // 빈도가 있는 연도가 없음
+	if(first == 0 && last == pList->num_year - 1) return;
+
+	resize_years(pList, pList->start_year + first, last - first + 1);
+}
+
+int load_names( FILE *fp, LIST *list){
+
+	int tmp_year;
+	int ok = 1;
+
+	NODE *pPre = NULL;
+	NODE *pLoc = NULL;
+	int idx;
+	tName *find = NULL;
+	tName probe; // 검색할 이름과 성별 (빈도는 쓰지 않으므로 stack에 둠)
+	SCANNER *sc = scan_Open( fp);
+	tRecord rec;
+
+	if(sc == NULL) return 0;
+
+	while(scan_Next( sc, &rec)){
+		scan_Copy( &rec, probe.name, sizeof(probe.name));
+		probe.sex = rec.sex;
+
+		tmp_year = year_index(list, rec.year);
+		if(tmp_year < 0){
+			ok = 0;
+			break;
+		}
+
+		// 이름과 성별이 모두 같은 경우
+		if( _search(list, &pPre, &pLoc, &idx, &probe) == 1){
+			NAME_AT(list, pLoc, idx)->freq[tmp_year] = rec.freq;
+		}
+		else{
+			find = _insert(list, pLoc, idx, &probe);
+			if(find == NULL){
+				ok = 0;
+				break;
+			}
+
+			find->freq[tmp_year] = rec.freq;
+		}
+
+	}
+
+	if(sc->error) ok = 0;
+
+	fit_years( list);
+
+	scan_Close( sc);
+
+	return ok;
+}
+
+int remove_names( FILE *fp, LIST *list){
+	char name[20];
+	char sex;
+	int num_delete = 0;
+
+	while(fscanf( fp, "%19s %c", name, &sex) == 2){
+		num_delete += removeName(list, name, sex);
+	}
+
+	return num_delete;
+}
+
+void print_names( LIST *pList){
+	WRITER *out = out_Open(stdout);
+
+	for(NODE *pLoc = pList->head; pLoc != NULL; pLoc = pLoc->link){
+		for(int i = 0; i < pLoc->count; i++){
+			tName *key = NAME_AT(pList, pLoc, i);
+
+			out_Str(out, key->name);
+			out_Char(out, '\t');
+			out_Char(out, key->sex);
+
+			for(int y = 0; y < pList->num_year; y++){
+				out_Char(out, '\t');
+				out_Int(out, key->freq[y]);
+			}
+
+			out_Char(out, '\n');
+		}
+	}
+
+	out_Close(out);
+}
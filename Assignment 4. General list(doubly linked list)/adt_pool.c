@@ -0,0 +1,75 @@
+#include <stdlib.h> // malloc
+
+#include "adt_pool.h"
+
+// block 앞부분 (다음 block 주소)의 크기
+#define BLOCK_HEADER	16
+
+////////////////////////////////////////////////////////////////////////////////
+POOL *pool_Create( size_t size, int per_block)
+{
+	POOL *pool = (POOL *)malloc( sizeof(POOL));
+	if (pool == NULL) return NULL;
+
+	// free list의 주소를 담을 수 있도록 포인터 크기의 배수로 올림
+	if (size < sizeof(void *)) size = sizeof(void *);
+	pool->size = (size + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+	pool->per_block = (per_block > 0) ? per_block : 1;
+	pool->free = NULL;
+	pool->cur = pool->end = NULL;
+	pool->blocks = NULL;
+
+	return pool;
+}
+
+void pool_Destroy( POOL *pool)
+{
+	void *block = pool->blocks;
+
+	while (block != NULL)
+	{
+		void *next = *(void **)block;
+		free( block);
+		block = next;
+	}
+
+	free( pool);
+}
+
+void *pool_Alloc( POOL *pool)
+{
+	void *ptr;
+
+	// 반납된 slot을 먼저 재사용
+	if (pool->free != NULL)
+	{
+		ptr = pool->free;
+		pool->free = *(void **)ptr;
+		return ptr;
+	}
+
+	// 현재 block을 다 쓰면 새 block을 할당
+	if (pool->cur == pool->end)
+	{
+		char *block = (char *)malloc( BLOCK_HEADER + pool->size * pool->per_block);
+		if (block == NULL) return NULL;
+
+		*(void **)block = pool->blocks;
+		pool->blocks = block;
+		pool->cur = block + BLOCK_HEADER;
+		pool->end = pool->cur + pool->size * pool->per_block;
+	}
+
+	ptr = pool->cur;
+	pool->cur += pool->size;
+
+	return ptr;
+}
+
+void pool_Free( POOL *pool, void *ptr)
+{
+	if (ptr == NULL) return;
+
+	*(void **)ptr = pool->free;
+	pool->free = ptr;
+}
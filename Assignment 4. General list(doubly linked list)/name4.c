@@ -1,8 +1,13 @@
 #include <stdlib.h> // malloc
 #include <stdio.h>
 #include <string.h> // strdup, strcmp
+#include <stddef.h> // offsetof
 #include <ctype.h> // toupper
 
+#include "name_scan.h"
+#include "name_out.h"
+#include "adt_pool.h"
+
 #define QUIT			1
 #define FORWARD_PRINT	2
 #define BACKWARD_PRINT	3
@@ -10,27 +15,33 @@
 #define DELETE			5
 #define COUNT			6
 
+#define POOL_SLOTS	1024	// pool block 하나의 slot 수
+#define NAME_UNIT	16		// 이름 구조체 pool의 slot 크기 단위 (bytes)
+#define NAME_CLASSES	8	// 이름 구조체 pool의 수 (NAME_UNIT * NAME_CLASSES bytes보다 큰 구조체는 malloc)
+
 // User structure type definition
-typedef struct 
+// list의 연결(llink, rlink)을 이름 구조체 안에 두어 node를 따로 할당하지 않음 (intrusive list)
+// 이름은 구조체 뒤에 NULL 문자까지 이어서 저장됨 (이름 구조체 하나에 한 번의 할당)
+typedef struct node
 {
-	char	*name;	// 이름
+	struct node	*llink; // 해당 node의 선행자를 가리킴
+	struct node	*rlink; // 해당 node의 후행자를 가리킴
 	int		freq;	// 빈도
+	char	name[];	// 이름
 } tName;
 
 ////////////////////////////////////////////////////////////////////////////////
 // LIST type definition
-typedef struct node
-{
-	tName		*dataPtr;
-	struct node	*llink; // 해당 node의 선행자를 가리킴
-	struct node	*rlink; // 해당 node의 후행자를 가리킴
-} NODE;
+// 데이터노드는 이름 구조체 자체
+typedef tName NODE;
 
 typedef struct
 {
 	int		count;
 	NODE	*head; // 첫번째 node를 가리킴
 	NODE	*rear; // 마지막 node를 가리킴
+	NODE	*finger; // 마지막으로 찾거나 삽입한 node (다음 _search의 시작점, NULL이면 head)
+	POOL	*name_pool[NAME_CLASSES]; // 이름 구조체(data node)의 pool (name_pool[c]의 slot은 (c+1) * NAME_UNIT bytes, 처음 쓸 때 생성)
 } LIST;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -43,6 +54,7 @@ LIST *createList(void);
 
 
 //  이름 리스트에 할당된 메모리를 해제 (head node, data node, name data)
+// 이름 구조체(data node)는 pool 단위로 한 번에 해제
 void destroyList( LIST *pList);
 
 // Inserts data into list
@@ -77,7 +89,7 @@ void traverseList( LIST *pList, void (*callback)(const tName *));
 void traverseListR( LIST *pList, void (*callback)(const tName *));
 
 // internal insert function
-// inserts data into list
+// inserts data into list (dataInPtr 자체가 node가 되므로 할당하지 않음)
 // return	1 if successful
 // 			0 if memory overflow
 static int _insert( LIST *pList, NODE *pPre, tName *dataInPtr);
@@ -88,18 +100,19 @@ static void _delete( LIST *pList, NODE *pPre, NODE *pLoc, tName **dataOutPtr);
 
 // internal search function
 // searches list and passes back address of node containing target and its logical predecessor
+// finger에서 시작하여 pArgu 쪽으로 (앞 또는 뒤로) 이동 (정렬되었거나 모여 있는 입력은 거의 이동하지 않음)
 // return	1 found
 // 			0 not found
 static int _search( LIST *pList, NODE **pPre, NODE **pLoc, tName *pArgu);
 
 ////////////////////////////////////////////////////////////////////////////////
-// Allocates dynamic memory for a name structure, initialize fields(name, freq) and returns its address to caller
+// Allocates memory for a name structure (with the name inline) from the pools of the list, initialize fields(name, freq) and returns its address to caller
 //	return	name structure pointer
 //			NULL if overflow
-tName *createName( char *name, int freq); 
+tName *createName( LIST *pList, char *name, int freq); 
 
-// Deletes all data in name structure and recycles memory
-void destroyName( tName *pNode);
+// Deletes all data in name structure and recycles memory (returns it to the pools of the list)
+void destroyName( LIST *pList, tName *pNode);
 
 ////////////////////////////////////////////////////////////////////////////////
 // gets user's input
@@ -133,11 +146,18 @@ int cmpName( const tName *pName1, const tName *pName2)
 	return strcmp( pName1->name, pName2->name);
 }
 
+// print_name의 출력 버퍼
+// traverseList의 callback에는 인자를 더 넘길 수 없으므로 전역으로 둠
+static WRITER *out;
+
 // prints contents of name structure
 // for traverseList and traverseListR functions
 void print_name(const tName *dataPtr)
 {
-	printf( "%s\t%d\n", dataPtr->name, dataPtr->freq);
+	out_Str( out, dataPtr->name);
+	out_Char( out, '\t');
+	out_Int( out, dataPtr->freq);
+	out_Char( out, '\n');
 }
 
 // increases freq in name structure
@@ -158,6 +178,8 @@ int main( int argc, char **argv)
 	tName *pName;
 	int ret;
 	FILE *fp;
+	SCANNER *sc;
+	tRecord rec;
 	
 	if (argc != 2){ // 입력 파일을 넣지 않으면 에러
 		fprintf( stderr, "usage: %s FILE\n", argv[0]);
@@ -179,18 +201,45 @@ int main( int argc, char **argv)
 		return 100;
 	}
 	
-	while(fscanf( fp, "%*d\t%s\t%*c\t%d", name, &freq) != EOF)
+	out = out_Open( stdout);
+	
+	sc = scan_Open( fp);
+	if (!sc)
+	{
+		fprintf( stderr, "Error: cannot read file [%s]\n", argv[1]);
+		fclose( fp);
+		if (out) out_Close( out);
+		destroyList( list);
+		return 2;
+	}
+	
+	while (scan_Next( sc, &rec))
 	{
-		pName = createName( name, freq);
+		scan_Copy( &rec, name, sizeof(name));
+		freq = rec.freq;
+		
+		pName = createName( list, name, freq);
 		
 		ret = addNode( list, pName);
 		
 		if (ret == 2) // duplicated
 		{
-			destroyName( pName);
+			destroyName( list, pName); // pool에 반납되어 다음 createName에서 재사용
 		}
 	}
 	
+	// 입력을 끝까지 읽지 못한 경우 (메모리 부족, 읽기 오류)
+	if (sc->error)
+	{
+		fprintf( stderr, "Error: cannot read file [%s]\n", argv[1]);
+		scan_Close( sc);
+		fclose( fp);
+		out_Close( out);
+		destroyList( list);
+		return 2;
+	}
+	
+	scan_Close( sc);
 	fclose( fp);
 	
 	fprintf( stderr, "Select Q)uit, P)rint, B)ackward print, S)earch, D)elete, C)ount: ");
@@ -198,11 +247,13 @@ int main( int argc, char **argv)
 	while (1) // 무한루프
 	{
 		tName *ptr;
+		union { tName key; char buf[sizeof(tName) + sizeof(name)]; } probe; // 검색, 삭제할 이름 (할당하지 않고 stack에 둠)
 		int action = get_action();
 		
 		switch( action)
 		{
 			case QUIT:
+				out_Close( out);
 				destroyList( list);
 				return 0;
 			
@@ -218,28 +269,26 @@ int main( int argc, char **argv)
 				fprintf( stderr, "Input a name to find: ");
 				fscanf( stdin, "%s", name);
 				
-				pName = createName( name, 0); // 검색할 이름으로 구조체 생성
+				strcpy( probe.key.name, name); // 검색할 이름
+				probe.key.freq = 0;
 
-				if (searchList( list, pName, &ptr)) print_name( ptr);
+				if (searchList( list, &probe.key, &ptr)) print_name( ptr);
 				else fprintf( stdout, "%s not found\n", name);
-				
-				destroyName( pName);
 				break;
 				
 			case DELETE:
 				fprintf( stderr, "Input a name to delete: ");
 				fscanf( stdin, "%s", name);
 				
-				pName = createName( name, 0); // 삭제할 이름으로 구조체 생성
+				strcpy( probe.key.name, name); // 삭제할 이름
+				probe.key.freq = 0;
 
-				if (removeNode( list, pName, &ptr))
+				if (removeNode( list, &probe.key, &ptr))
 				{
 					fprintf( stdout, "(%s, %d) deleted\n", ptr->name, ptr->freq);
-					destroyName( ptr); // 기존 list에 있던 구조체
+					destroyName( list, ptr); // 기존 list에 있던 구조체
 				}
 				else fprintf( stdout, "%s not found\n", name);
-				
-				destroyName( pName); 
 				break;
 			
 			case COUNT:
@@ -247,6 +296,8 @@ int main( int argc, char **argv)
 				break;
 		}
 		
+		out_Flush( out); // 다른 stdout 출력보다 먼저 내보냄
+		
 		if (action) fprintf( stderr, "Select Q)uit, P)rint, B)ackward print, S)earch, D)elete, C)ount: ");
 	}
 	return 0;
@@ -261,6 +312,9 @@ LIST *createList(void){
 	key->count = 0;
 	key->head =  NULL; // 디버깅 완료
 	key->rear = NULL;
+	key->finger = NULL;
+
+	for(int c = 0; c < NAME_CLASSES; c++) key->name_pool[c] = NULL;
 
 	return key;
 
@@ -270,14 +324,16 @@ void destroyList( LIST *pList){
 	NODE *pLoc = pList->head;
 	NODE *pNext = NULL; 
 
+	// pool에 들어가지 않는 긴 이름 구조체만 따로 해제
 	while(pLoc != NULL){
 		pNext = pLoc->rlink;
-		destroyName(pLoc->dataPtr);
-		free(pLoc);
+		if((offsetof(tName, name) + strlen(pLoc->name)) / NAME_UNIT >= NAME_CLASSES) free(pLoc);
 		pLoc = pNext;
-
 	}
 
+	for(int c = 0; c < NAME_CLASSES; c++)
+		if(pList->name_pool[c] != NULL) pool_Destroy(pList->name_pool[c]);
+
 	free(pList);
 
 }
@@ -287,7 +343,7 @@ int addNode( LIST *pList, tName *dataInPtr){
 	NODE* pLoc;
 	
 	if(_search(pList, &pPre, &pLoc, dataInPtr) == 1){
-		increase_freq(pLoc->dataPtr, dataInPtr);
+		increase_freq(pLoc, dataInPtr);
 		return 2;
 	}
 
@@ -321,7 +377,7 @@ int searchList( LIST *pList, tName *pArgu, tName **dataOutPtr){
 	NODE* pLoc;
 
 	if(_search(pList, &pPre, &pLoc, pArgu) == 1){
-		*dataOutPtr = pLoc->dataPtr;
+		*dataOutPtr = pLoc;
 		return 1;
 	}
 
@@ -345,7 +401,7 @@ void traverseList( LIST *pList, void (*callback)(const tName *)){
 	NODE* pLoc = pList->head;
 
 	while(pLoc != NULL){
-		(*callback)(pLoc->dataPtr);
+		(*callback)(pLoc);
 		pLoc = pLoc->rlink;
 	}
 
@@ -355,7 +411,7 @@ void traverseListR( LIST *pList, void (*callback)(const tName *)){
 	NODE* pLoc = pList->rear;
 
 	while(pLoc != NULL){
-		(*callback)(pLoc->dataPtr);
+		(*callback)(pLoc);
 		pLoc = pLoc->llink; // 역방향으로 이동
 	}
 
@@ -363,10 +419,8 @@ void traverseListR( LIST *pList, void (*callback)(const tName *)){
 
 static int _insert( LIST *pList, NODE *pPre, tName *dataInPtr){
 	// addNode에서 사용
-	NODE* pNew = (NODE*)malloc(sizeof(NODE));
-	if(pNew == NULL) return 0;
+	NODE* pNew = dataInPtr;
 
-	pNew->dataPtr = dataInPtr;
 	pNew->llink =  NULL, pNew->rlink = NULL;
 
 	if(pPre == NULL){ // 처음에 삽입
@@ -400,31 +454,31 @@ static int _insert( LIST *pList, NODE *pPre, tName *dataInPtr){
 		}
 	}
 
+	pList->finger = pNew;
+
 	pList->count ++;
 	return 1;
 }
 
 static void _delete( LIST *pList, NODE *pPre, NODE *pLoc, tName **dataOutPtr){
 	// removeNode에서 사용
-	*dataOutPtr = pLoc->dataPtr;
+	*dataOutPtr = pLoc;
+	pList->finger = (pPre != NULL) ? pPre : pLoc->rlink; // 삭제되는 node를 가리키지 않도록
 	
 	if(pLoc->rlink == NULL){ // 마지막 node를 삭제
 		pPre->rlink = NULL;
 		pList->rear = pPre;
-		free(pLoc);
 	}
 
 	else{
 		if(pLoc->llink == NULL){ // 첫번째 node를 삭제
 			pLoc->rlink->llink = NULL;
 			pList->head = pLoc->rlink;
-			free(pLoc);
 		}
 
 		else{ // 중간 node를 삭제
 			pPre->rlink = pLoc->rlink;
 			pLoc->rlink->llink = pPre;
-			free(pLoc);
 		}
 	}
 
@@ -433,43 +487,66 @@ static void _delete( LIST *pList, NODE *pPre, NODE *pLoc, tName **dataOutPtr){
 }
 
 static int _search( LIST *pList, NODE **pPre, NODE **pLoc, tName *pArgu){
-	*pPre = NULL;
-	*pLoc = pList->head;
+	*pLoc = (pList->finger != NULL) ? pList->finger : pList->head;
 
-	if(*pLoc == NULL) return 0;
+	if(*pLoc == NULL){
+		*pPre = NULL;
+		return 0;
+	}
 
-	while(*pLoc != NULL && cmpName(pArgu, (*pLoc)->dataPtr) > 0){
-		// 현재 node의 이름보다 사전순상 뒤에 위치할 경우
-		*pPre = *pLoc;
-		*pLoc = (*pLoc)->rlink; 
+	if(cmpName(pArgu, *pLoc) > 0){
+		// finger보다 뒤: 앞으로 이동
+		while(*pLoc != NULL && cmpName(pArgu, *pLoc) > 0){
+			// 현재 node의 이름보다 사전순상 뒤에 위치할 경우
+			*pLoc = (*pLoc)->rlink; 
+		}
+		*pPre = (*pLoc != NULL) ? (*pLoc)->llink : pList->rear;
 	}
+	else{
+		// finger와 같거나 앞: 선행 node가 pArgu보다 작아질 때까지 뒤로 이동
+		while((*pLoc)->llink != NULL && cmpName(pArgu, (*pLoc)->llink) <= 0)
+			*pLoc = (*pLoc)->llink;
+		*pPre = (*pLoc)->llink;
+	}
+
+	pList->finger = (*pLoc != NULL) ? *pLoc : *pPre;
 
 	if(*pLoc == NULL) // 디버깅 완료
 		return 0;
 
-	if(cmpName(pArgu, (*pLoc)->dataPtr) == 0) 
+	if(cmpName(pArgu, *pLoc) == 0) 
 		return 1;
 	else 
 		return 0;
 
 }
 
-tName *createName( char *name, int freq){
+tName *createName( LIST *pList, char *name, int freq){
 	// 초기화 하면서 이름 구조체 생성
-	tName* key = (tName*)malloc(sizeof(tName));
+	size_t len = strlen(name);
+	size_t c = (offsetof(tName, name) + len) / NAME_UNIT; // 크기별 pool (문자열 끝에는 NULL이 있음(+1))
+	tName* key;
+
+	if(c < NAME_CLASSES){
+		if(pList->name_pool[c] == NULL) pList->name_pool[c] = pool_Create((c + 1) * NAME_UNIT, POOL_SLOTS);
+		key = (pList->name_pool[c] != NULL) ? (tName*)pool_Alloc(pList->name_pool[c]) : NULL;
+	}
+	else key = (tName*)malloc(offsetof(tName, name) + len + 1);
+
 	if(key == NULL) return NULL;
 
-	key->name = (char*)malloc(sizeof(char) * (strlen(name) + 1)); // 문자열 끝에는 NULL이 있음(+1)
-	strcpy(key->name, name);
+	memcpy(key->name, name, len + 1);
 	key->freq = freq;
 
 	return key;
 
 }
 
-void destroyName( tName *pNode){
-	// 이름 구조체의 메모리 해제
-	free(pNode->name);
-	free(pNode);
+void destroyName( LIST *pList, tName *pNode){
+	// 이름 구조체의 메모리를 pool에 반납
+	size_t c = (offsetof(tName, name) + strlen(pNode->name)) / NAME_UNIT;
+
+	if(c < NAME_CLASSES) pool_Free(pList->name_pool[c], pNode);
+	else free(pNode);
 
 }
@@ -0,0 +1,42 @@
+// 출력 버퍼
+// 출력을 큰 버퍼에 모아 한 번에 fwrite로 내보냄
+// printf와 달리 형식 문자열 해석과 호출마다의 stream lock이 없음
+
+#include <stdio.h> // FILE
+#include <stddef.h> // size_t
+
+typedef struct
+{
+	FILE	*fp;	// 출력 파일 (NULL이면 메모리 버퍼: 내보내지 않고 버퍼를 늘림)
+	char	*buf;	// 출력 버퍼
+	size_t	len;	// 버퍼에 쌓인 길이
+	size_t	size;	// 버퍼의 크기
+} WRITER;
+
+////////////////////////////////////////////////////////////////////////////////
+// function declarations
+
+// 출력 버퍼를 생성
+// fp가 NULL이면 메모리 버퍼 (buf, len으로 결과를 읽음)
+// 주의사항: 같은 fp에 다른 함수(printf 등)로 출력하기 전에 out_Flush 해야 순서가 유지됨
+// return	출력 버퍼 포인터
+//			NULL if overflow
+WRITER *out_Open( FILE *fp);
+
+// 버퍼에 남은 내용을 내보내고 할당된 메모리를 해제
+void out_Close( WRITER *w);
+
+// 버퍼에 쌓인 내용을 fp로 내보냄 (메모리 버퍼는 아무 일도 하지 않음)
+void out_Flush( WRITER *w);
+
+// n bytes를 출력
+void out_Mem( WRITER *w, const char *s, size_t n);
+
+// NULL 문자로 끝나는 문자열을 출력
+void out_Str( WRITER *w, const char *s);
+
+// 문자 하나를 출력
+void out_Char( WRITER *w, char c);
+
+// 정수를 10진수로 출력 (printf("%d")와 같은 결과)
+void out_Int( WRITER *w, int v);
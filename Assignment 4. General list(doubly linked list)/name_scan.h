@@ -0,0 +1,62 @@
+// 이름 정보 입력 파일 토크나이저
+// 입력 파일을 mmap으로 매핑하여 한 줄씩 (연도, 이름, 성별, 빈도) 레코드를 읽음
+// fscanf와 달리 버퍼 복사와 locale 처리가 없음
+// 매핑할 수 없는 입력(파이프 등)은 읽기 스레드가 다음 청크를 읽는 동안 현재 청크를 파싱 (-lpthread)
+
+#include <stdio.h> // FILE
+#include <stddef.h> // size_t
+
+// 레코드 구조체
+// name은 입력 버퍼 안을 가리키며 NULL 문자로 끝나지 않음 (길이는 name_len)
+// 다음 scan_Next 호출 전까지만 유효한 것으로 간주해야 함
+typedef struct
+{
+	int			year;		// 연도
+	const char	*name;		// 이름 (입력 버퍼 안의 위치)
+	int			name_len;	// 이름의 길이
+	char		sex;		// 성별 M or F
+	int			freq;		// 빈도
+} tRecord;
+
+typedef struct
+{
+	const char	*buf;	// 입력 버퍼의 시작
+	const char	*cur;	// 다음에 읽을 위치
+	const char	*end;	// 입력 버퍼의 끝
+	size_t		size;	// 할당(매핑)된 크기
+	int			mapped;	// 1: mmap, 0: malloc
+	const char	*ahead;	// 매핑된 입력에서 다음에 미리 읽기를 요청할 위치 (NULL이면 요청하지 않음)
+	void		*stream;	// 읽기 스레드의 상태 (NULL이면 입력 전체가 buf에 있음)
+	int			error;	// 1: 입력을 끝까지 읽지 못함 (메모리 부족, 읽기 오류)
+} SCANNER;
+
+////////////////////////////////////////////////////////////////////////////////
+// function declarations
+
+// 파일의 현재 위치부터 끝까지를 읽을 수 있는 토크나이저를 생성
+// 일반 파일은 mmap으로 매핑하고, 읽는 위치보다 앞의 구간을 미리 읽도록 요청함 (MADV_WILLNEED)
+// 파이프 등 매핑할 수 없는 입력은 읽기 스레드가 두 개의 버퍼를 번갈아 채우고, scan_Next가 청크 단위로 가져감
+// 주의사항: 스트림 입력은 scan_Close 전까지 읽기 스레드가 fp를 사용함
+// return	토크나이저 포인터
+//			NULL if overflow
+SCANNER *scan_Open( FILE *fp);
+
+// 토크나이저에 할당된 메모리(매핑)를 해제 (읽기 스레드가 있으면 멈추고 기다림)
+void scan_Close( SCANNER *sc);
+
+// 다음 레코드를 읽음
+// 형식이 맞지 않는 줄은 건너뜀
+// 주의사항: 0을 반환한 후 sc->error를 확인해야 함 (1이면 입력의 끝이 아니라 읽기 실패)
+// return	1 successful
+//			0 end of input (or error)
+int scan_Next( SCANNER *sc, tRecord *rec);
+
+// 입력을 줄 단위로 n개의 구간으로 나누어, k번째(0부터) 구간만 읽는 토크나이저를 part에 설정
+// part는 sc의 버퍼를 공유하므로 scan_Close 하지 않으며, sc보다 먼저 사용이 끝나야 함
+// 구간들은 서로 겹치지 않고 모두 합하면 sc의 남은 입력 전체가 됨
+// 스트림 입력은 나눌 수 없으므로 0번째 구간이 남은 입력 전체가 되고 나머지 구간은 비어 있음
+void scan_Slice( const SCANNER *sc, int k, int n, SCANNER *part);
+
+// 레코드의 이름을 NULL 문자로 끝나는 문자열로 복사하고, dst의 남은 자리(size까지)는 0으로 채움
+// size보다 긴 이름은 size-1 글자로 잘림
+void scan_Copy( const tRecord *rec, char *dst, int size);
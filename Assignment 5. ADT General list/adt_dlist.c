@@ -2,6 +2,8 @@
 
 #include "adt_dlist.h"
 
+#define POOL_SLOTS	1024	// data node pool의 block 하나의 slot 수
+
 // internal insert function
 // inserts data into list
 // return	1 if successful
@@ -21,7 +23,7 @@ static int _search( LIST *pList, NODE **pPre, NODE **pLoc, void *pArgu);
 ////////////////////////////////////////////////////////////////////////////////
 static int _insert( LIST *pList, NODE *pPre, void *dataInPtr){
 
-    NODE* pNew = (NODE*)malloc(sizeof(NODE));
+    NODE* pNew = (NODE*)pool_Alloc(pList->node_pool);
 	if(pNew == NULL) return 0;
 
 	pNew->dataPtr = dataInPtr;
@@ -70,20 +72,20 @@ static void _delete( LIST *pList, NODE *pPre, NODE *pLoc, void **dataOutPtr){
 	if(pLoc->rlink == NULL){ // 마지막 node를 삭제
 		pPre->rlink = NULL;
 		pList->rear = pPre;
-		free(pLoc);
+		pool_Free(pList->node_pool, pLoc);
 	}
 
 	else{
 		if(pLoc->llink == NULL){ // 첫번째 node를 삭제
 			pLoc->rlink->llink = NULL;
 			pList->head = pLoc->rlink;
-			free(pLoc);
+			pool_Free(pList->node_pool, pLoc);
 		}
 
 		else{ // 중간 node를 삭제
 			pPre->rlink = pLoc->rlink;
 			pLoc->rlink->llink = pPre;
-			free(pLoc);
+			pool_Free(pList->node_pool, pLoc);
 		}
 	}
 
@@ -125,6 +127,12 @@ LIST *createList( int (*compare)(const void *, const void *)){
     key->rear = NULL;
     key->compare = compare;
 
+    key->node_pool = pool_Create(sizeof(NODE), POOL_SLOTS);
+    if(key->node_pool == NULL){
+        free(key);
+        return NULL;
+    }
+
     return key;
 
 }
@@ -137,10 +145,10 @@ void destroyList( LIST *pList, void (*callback)(void *)){
     while(pLoc != NULL){
         pNext = pLoc->rlink;
         (*callback)(pLoc->dataPtr); // main에서 destroyName 호출
-        free(pLoc);
         pLoc = pNext;
     }
 
+    pool_Destroy(pList->node_pool); // data node는 한 번에 해제
     free(pList);
 
 }
@@ -1,4 +1,6 @@
 
+#include "adt_pool.h"
+
 ////////////////////////////////////////////////////////////////////////////////
 // LIST type definition
 typedef struct node
@@ -14,6 +16,7 @@ typedef struct
 	NODE	*head;
 	NODE	*rear;
 	int		(*compare)(const void *, const void *); // used in _search function
+	POOL	*node_pool; // data node의 pool (destroyList에서 한 번에 해제)
 } LIST;
 
 ////////////////////////////////////////////////////////////////////////////////
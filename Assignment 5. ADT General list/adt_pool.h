@@ -0,0 +1,34 @@
+// 고정 크기 slot 할당기 (memory pool)
+// 큰 block을 한 번에 할당해 같은 크기의 slot으로 나누어 쓰고, 반납된 slot은 free list로 재사용
+// slot마다 malloc/free를 부르지 않고, pool_Destroy에서 모든 block을 한 번에 해제
+
+#include <stddef.h> // size_t
+
+typedef struct
+{
+	size_t	size;		// slot 하나의 크기 (포인터 크기의 배수)
+	int		per_block;	// block 하나의 slot 수
+	void	*free;		// 반납된 slot의 list (slot의 앞부분에 다음 slot 주소를 저장)
+	char	*cur;		// 현재 block에서 아직 쓰지 않은 첫번째 slot
+	char	*end;		// 현재 block의 끝
+	void	*blocks;	// 할당된 block의 list (block의 앞부분에 다음 block 주소를 저장)
+} POOL;
+
+////////////////////////////////////////////////////////////////////////////////
+// function declarations
+
+// size bytes slot의 pool을 생성 (block은 처음 pool_Alloc할 때 할당)
+// return	pool 포인터
+//			NULL if overflow
+POOL *pool_Create( size_t size, int per_block);
+
+// pool에서 할당된 모든 slot과 pool을 해제
+void pool_Destroy( POOL *pool);
+
+// slot 하나를 할당 (초기화하지 않음)
+// return	slot 포인터
+//			NULL if overflow
+void *pool_Alloc( POOL *pool);
+
+// slot을 pool에 반납 (다음 pool_Alloc에서 재사용)
+void pool_Free( POOL *pool, void *ptr);
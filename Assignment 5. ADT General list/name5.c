@@ -1,9 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h> // malloc
 #include <string.h> // strdup, strcmp
+#include <stddef.h> // offsetof
 #include <ctype.h> // toupper
 
-#include "adt_dlist.h"
+#include "adt_dlist.h" // adt_pool.h
+#include "name_scan.h"
+#include "name_out.h"
 
 #define QUIT			1
 #define FORWARD_PRINT	2
@@ -12,29 +15,48 @@
 #define DELETE			5
 #define COUNT			6
 
+#define POOL_SLOTS	1024	// pool block 하나의 slot 수
+#define NAME_UNIT	16		// 이름 구조체 pool의 slot 크기 단위 (bytes)
+#define NAME_CLASSES	8	// 이름 구조체 pool의 수 (NAME_UNIT * NAME_CLASSES bytes보다 큰 구조체는 malloc)
 
 // User structure type definition
+// 이름은 구조체 뒤에 NULL 문자까지 이어서 저장됨 (이름 구조체 하나에 한 번의 할당)
 typedef struct 
 {
-	char	*name;	// 이름
 	int		freq;	// 빈도
+	char	name[];	// 이름
 } tName;
 
 ////////////////////////////////////////////////////////////////////////////////
-// Allocates dynamic memory for a name structure, initialize fields(name, freq) and returns its address to caller
+// Allocates memory for a name structure (with the name inline) from the pools, initialize fields(name, freq) and returns its address to caller
 //	return	name structure pointer
 //			NULL if overflow
 tName *createName( char *name, int freq); 
 
-// Deletes all data in name structure and recycles memory
+// Deletes all data in name structure and recycles memory (returns it to the pools)
 void destroyName( void *pName);
 
+// pool에서 할당된 모든 이름 구조체를 한 번에 해제
+void destroy_pools(void);
+
+////////////////////////////////////////////////////////////////////////////////
+// 이름 구조체의 pool (name_pool[c]의 slot은 (c+1) * NAME_UNIT bytes, 처음 쓸 때 생성)
+// destroyName은 destroyList의 callback이므로 인자를 더 넘길 수 없어 전역으로 둠
+static POOL *name_pool[NAME_CLASSES];
+
 ////////////////////////////////////////////////////////////////////////////////
+// print_name의 출력 버퍼
+// traverseList의 callback에는 인자를 더 넘길 수 없으므로 전역으로 둠
+static WRITER *out;
+
 // prints contents of name structure
 // for traverseList and traverseListR functions
 void print_name(const void *dataPtr)
 {
-	printf( "%s\t%d\n", ((tName *)dataPtr)->name, ((tName *)dataPtr)->freq);
+	out_Str( out, ((tName *)dataPtr)->name);
+	out_Char( out, '\t');
+	out_Int( out, ((tName *)dataPtr)->freq);
+	out_Char( out, '\n');
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -90,6 +112,8 @@ int main( int argc, char **argv)
 	tName *pName;
 	int ret;
 	FILE *fp;
+	SCANNER *sc;
+	tRecord rec;
 	
 	if (argc != 2) {
 		fprintf( stderr, "usage: %s FILE\n", argv[0]);
@@ -111,18 +135,47 @@ int main( int argc, char **argv)
 		return 100;
 	}
 	
-	while(fscanf( fp, "%*d\t%s\t%*c\t%d", name, &freq) != EOF)
+	out = out_Open( stdout);
+	
+	sc = scan_Open( fp);
+	if (!sc)
+	{
+		fprintf( stderr, "Error: cannot read file [%s]\n", argv[1]);
+		fclose( fp);
+		if (out) out_Close( out);
+		destroyList( list, destroyName);
+		destroy_pools();
+		return 2;
+	}
+	
+	while (scan_Next( sc, &rec))
 	{
+		scan_Copy( &rec, name, sizeof(name));
+		freq = rec.freq;
+		
 		pName = createName( name, freq);
 		
 		ret = addNode( list, pName, increase_freq);
 		
 		if (ret == 0 || ret == 2) // failure or duplicated
 		{
-			destroyName( pName);
+			destroyName( pName); // pool에 반납되어 다음 createName에서 재사용
 		}
 	}
 	
+	// 입력을 끝까지 읽지 못한 경우 (메모리 부족, 읽기 오류)
+	if (sc->error)
+	{
+		fprintf( stderr, "Error: cannot read file [%s]\n", argv[1]);
+		scan_Close( sc);
+		fclose( fp);
+		out_Close( out);
+		destroyList( list, destroyName);
+		destroy_pools();
+		return 2;
+	}
+	
+	scan_Close( sc);
 	fclose( fp);
 	
 	fprintf( stderr, "Select Q)uit, P)rint, B)ackward print, S)earch, D)elete, C)ount: ");
@@ -130,12 +183,15 @@ int main( int argc, char **argv)
 	while (1)
 	{
 		void *ptr;
+		union { tName key; char buf[sizeof(tName) + sizeof(name)]; } probe; // 검색, 삭제할 이름 (할당하지 않고 stack에 둠)
 		int action = get_action();
 		
 		switch( action)
 		{
 			case QUIT:
+				out_Close( out);
 				destroyList( list, destroyName);
+				destroy_pools();
 				return 0;
 			
 			case FORWARD_PRINT:
@@ -150,28 +206,26 @@ int main( int argc, char **argv)
 				fprintf( stderr, "Input a name to find: ");
 				fscanf( stdin, "%s", name);
 				
-				pName = createName( name, 0);
+				strcpy( probe.key.name, name);
+				probe.key.freq = 0;
 
-				if (searchList( list, pName, &ptr)) print_name( ptr);
+				if (searchList( list, &probe.key, &ptr)) print_name( ptr);
 				else fprintf( stdout, "%s not found\n", name);
-				
-				destroyName( pName);
 				break;
 				
 			case DELETE:
 				fprintf( stderr, "Input a name to delete: ");
 				fscanf( stdin, "%s", name);
 				
-				pName = createName( name, 0);
+				strcpy( probe.key.name, name);
+				probe.key.freq = 0;
 
-				if (removeNode( list, pName, &ptr))
+				if (removeNode( list, &probe.key, &ptr))
 				{
 					fprintf( stdout, "(%s, %d) deleted\n", ((tName *)ptr)->name, ((tName *)ptr)->freq);
 					destroyName( (tName *)ptr);
 				}
 				else fprintf( stdout, "%s not found\n", name);
-				
-				destroyName( pName);
 				break;
 			
 			case COUNT:
@@ -179,6 +233,8 @@ int main( int argc, char **argv)
 				break;
 		}
 		
+		out_Flush( out); // 다른 stdout 출력보다 먼저 내보냄
+		
 		if (action) fprintf( stderr, "Select Q)uit, P)rint, B)ackward print, S)earch, D)elete, C)ount: ");
 	}
 	return 0;
@@ -186,11 +242,19 @@ int main( int argc, char **argv)
 
 ////////////////////////////////////////////////////////////////////////////////
 tName *createName( char *name, int freq){
-	tName* key = (tName*)malloc(sizeof(tName));
+	size_t len = strlen(name);
+	size_t c = (offsetof(tName, name) + len) / NAME_UNIT; // 크기별 pool (NULL 문자 포함)
+	tName* key;
+
+	if(c < NAME_CLASSES){
+		if(name_pool[c] == NULL) name_pool[c] = pool_Create((c + 1) * NAME_UNIT, POOL_SLOTS);
+		key = (name_pool[c] != NULL) ? (tName*)pool_Alloc(name_pool[c]) : NULL;
+	}
+	else key = (tName*)malloc(offsetof(tName, name) + len + 1);
+
 	if(key == NULL) return NULL; // overflow
 
-	key->name = (char*)malloc(sizeof(char) * (strlen(name) + 1));
-	strcpy(key->name, name);
+	memcpy(key->name, name, len + 1);
 	key->freq = freq;
 
 	return key;
@@ -198,7 +262,14 @@ tName *createName( char *name, int freq){
 
 void destroyName( void *pName){
 	// casting 후 접근
-	free(((tName*)pName)->name);
-	free((tName*)pName);
+	size_t c = (offsetof(tName, name) + strlen(((tName*)pName)->name)) / NAME_UNIT;
+
+	if(c < NAME_CLASSES) pool_Free(name_pool[c], pName);
+	else free(pName);
+
+}
 
+void destroy_pools(void){
+	for(int c = 0; c < NAME_CLASSES; c++)
+		if(name_pool[c] != NULL) pool_Destroy(name_pool[c]);
 }